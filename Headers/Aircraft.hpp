@@ -6,15 +6,23 @@
 #include "ResourceIdentifiers.hpp"
 #include "Projectile.hpp"
 #include "TextNode.hpp"
-#include "Animation.hpp"
+#include "TimerWheel.hpp"
+#include "BehaviorSystem.hpp"
+#include "ParticleRegistry.hpp"
 
 #include <SFML/Graphics/Sprite.hpp>
 
 
 
+class BulletNode;
+class EmitterNode;
+class AircraftPool;
 
 class Aircraft : public Entity
 {
+	friend class AircraftPool;
+
+
 public:
 	enum Type
 	{
@@ -25,53 +33,107 @@ public:
 		TypeCount
 	};
 
+	enum DetailLevel
+	{
+		FullDetail,
+		ReducedDetail,
+		MinimalDetail,
+		DetailLevelCount
+	};
+
 
 public:
-	Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts);
+	Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts, TimerWheel& timers, BehaviorSystem& behaviors,
+		ParticleRegistry& particles);
+	virtual				~Aircraft();
 
 	virtual unsigned int	getCategory() const;
 	virtual sf::FloatRect	getBoundingRect() const;
 	virtual Type			getType() const;
 	virtual void			remove();
 	virtual bool 			isMarkedForRemoval() const;
+	bool					hasExploded() const;
 	bool					isAllied() const;
 	float				getMaxSpeed() const;
 
+	void					setDetailLevel(DetailLevel level);
+	DetailLevel			getDetailLevel() const;
+
+	int					getIdentifier() const;
+	void					setIdentifier(int identifier);
+	void					setMovementPattern(Type pattern, std::size_t step = 0, sf::Time delay = sf::Time::Zero);
+	void					setFormation(sf::Uint32 formation);
+	sf::Uint32				getFormation() const;
+
+	virtual void			saveState(EntityState& state) const;
+	virtual void			loadState(const EntityState& state);
+
 	void                     increaseSpeed();
 	void					increaseFireRate();
 	void					increaseSpread();
 	void					collectMissiles(unsigned int count);
 
 	void 				fire();
+	void					fireBurstShot();
 	void					launchMissile();
 	void					playLocalSound(CommandQueue& commands, SoundEffect::ID effect);
+	void					createExplosion(CommandQueue& commands) const;
 	static void              updateGame();
 
 private:
+	// Only touches data that is safe to build on a worker thread, the pool finishes the aircraft on the main thread
+							Aircraft(Type type, const TextureHolder& textures, TimerWheel& timers, BehaviorSystem& behaviors,
+								ParticleRegistry& particles);
+	void					createTexts(const FontHolder& fonts);
+	void					spawn();
+	void					despawn();
+
 	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual bool			batchCurrent(SpriteBatch& batch, const sf::Transform& transform) const;
 	virtual void 			updateCurrent(sf::Time dt, CommandQueue& commands);
-	void					updateMovementPattern(sf::Time dt);
+	void					startBehavior(std::size_t step, TimerWheel::Tick delay, int burstShots);
+	void					stopBehavior();
 	void					checkPickupDrop(CommandQueue& commands);
 	void					checkProjectileLaunch(sf::Time dt, CommandQueue& commands);
+	void					scheduleGunReady();
+	void					updateBulletPattern(sf::Time dt, CommandQueue& commands);
 
-	void					createBullets(SceneNode& node, const TextureHolder& textures) const;
+	void					createBullets(BulletNode& bullets) const;
+	void					createBullet(BulletNode& bullets, Projectile::Type type, float xOffset, float yOffset) const;
 	void					createProjectile(SceneNode& node, Projectile::Type type, float xOffset, float yOffset, const TextureHolder& textures) const;
 	void					createPickup(SceneNode& node, const TextureHolder& textures) const;
 
 	void					updateTexts();
 	void					updateRollAnimation();
+	void					updateSmoke();
+	void					stopSmoke();
 
 
 
 
 private:
 	Type					mType;
+	Type					mMovementPattern;
 	sf::Sprite			mSprite;
-	Animation				mExplosion;
 	Command 				mFireCommand;
 	Command				mMissileCommand;
-	sf::Time				mFireCountdown;
+	TimerWheel&			mTimers;
+	sf::Time				mFireReadyTime;
+	TimerWheel::ID			mFireTimer;
+	BehaviorSystem&		mBehaviors;
+	ParticleRegistry&		mParticles;
+	EmitterNode*			mSmoke;
+	BehaviorSystem::Frame	mBehavior;
+	DetailLevel			mDetailLevel;
+	sf::Time				mSkippedTime;
+	sf::Time				mPatternTime;
+	std::size_t			mUpdateCounter;
+	int					mIdentifier;
+	sf::Uint32				mFormation;
 	bool 				mIsFiring;
+	bool					mIsGunReady;
+	bool					mIsFiringBurstShot;
+	bool					mFiresInBursts;
 	bool					mIsLaunchingMissile;
 	bool 				mShowExplosion;
 	bool					mPlayedExplosionSound;
@@ -88,10 +150,10 @@ private:
 
 
 	Command 				mDropPickupCommand;
-	float				mTravelledDistance;
-	std::size_t			mDirectionIndex;
 	TextNode*				mHealthDisplay;
 	TextNode*				mMissileDisplay;
+	int					mDisplayedHitpoints;
+	int					mDisplayedMissiles;
 };
 
 #endif // AIRCRAFT_HPP
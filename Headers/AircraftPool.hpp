@@ -0,0 +1,71 @@
+#ifndef AIRCRAFTPOOL_HPP
+#define AIRCRAFTPOOL_HPP
+
+#include "Aircraft.hpp"
+#include "ResourceIdentifiers.hpp"
+#include "TimerWheel.hpp"
+#include "BehaviorSystem.hpp"
+#include "ParticleRegistry.hpp"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/Mutex.hpp>
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <memory>
+
+
+// Keeps spare enemy aircraft of every type, so that spawning a dense row doesn't construct them all at once.
+// The pool is prewarmed when the level loads, enemies reserved ahead of the view are built on a worker
+// thread, and shot down enemies are handed back to be used again.
+class AircraftPool : private sf::NonCopyable
+{
+public:
+	typedef std::unique_ptr<Aircraft> AircraftPtr;
+
+
+public:
+							AircraftPool(const TextureHolder& textures, const FontHolder& fonts, TimerWheel& timers, BehaviorSystem& behaviors,
+								ParticleRegistry& particles);
+							~AircraftPool();
+
+	void					reserve(Aircraft::Type type);
+	void					clearReservations();
+	void					prewarm();
+
+	AircraftPtr			acquire(Aircraft::Type type);
+	void					release(AircraftPtr aircraft);
+
+
+private:
+	typedef std::vector<AircraftPtr> AircraftList;
+
+
+private:
+	AircraftPtr			construct(Aircraft::Type type) const;
+	void					collectBuilt();
+	void					runWorker();
+
+
+private:
+	const TextureHolder&							mTextures;
+	const FontHolder&								mFonts;
+	TimerWheel&									mTimers;
+	BehaviorSystem&								mBehaviors;
+	ParticleRegistry&								mParticles;
+
+	std::array<AircraftList, Aircraft::TypeCount>	mFree;
+	std::array<std::size_t, Aircraft::TypeCount>	mReserved;
+	std::array<std::size_t, Aircraft::TypeCount>	mPending;
+
+	// Shared with the worker thread, guarded by mMutex
+	sf::Thread									mWorker;
+	sf::Mutex										mMutex;
+	std::deque<Aircraft::Type>					mJobs;
+	AircraftList									mBuilt;
+	bool											mIsWorking;
+};
+
+#endif // AIRCRAFTPOOL_HPP
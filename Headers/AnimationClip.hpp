@@ -0,0 +1,43 @@
+#ifndef ANIMATIONCLIP_HPP
+#define ANIMATIONCLIP_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <vector>
+
+
+namespace sf
+{
+	class Texture;
+}
+
+// The frames of an animation sheet, computed once and shared by every Animation playing them.
+// Finding the frame for a point in time is a single lookup in the table.
+class AnimationClip : private sf::NonCopyable
+{
+public:
+							AnimationClip(const sf::Texture& texture, sf::Vector2i frameSize, std::size_t numFrames, sf::Time duration, bool repeat);
+
+	const sf::Texture&		getTexture() const;
+	sf::Vector2i			getFrameSize() const;
+	std::size_t			getNumFrames() const;
+	sf::Time				getDuration() const;
+	bool					isRepeating() const;
+
+	std::size_t			getFrameIndex(sf::Time elapsedTime) const;
+	const sf::IntRect&		getFrame(sf::Time elapsedTime) const;
+	bool					isFinished(sf::Time elapsedTime) const;
+
+
+private:
+	const sf::Texture*		mTexture;
+	sf::Vector2i			mFrameSize;
+	std::vector<sf::IntRect>	mFrames;
+	sf::Time				mDuration;
+	sf::Time				mTimePerFrame;
+	bool					mRepeat;
+};
+
+#endif // ANIMATIONCLIP_HPP
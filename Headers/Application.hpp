@@ -7,16 +7,19 @@
 #include "StateStack.hpp"
 #include "MusicPlayer.hpp"
 #include "SoundPlayer.hpp"
+#include "Autopilot.hpp"
 
 #include <SFML/System/Time.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Text.hpp>
 
+#include <memory>
+
 
 class Application
 {
 	public:
-							Application();
+							Application(int argc, char* argv[]);
 		void					run();
 		
 
@@ -25,7 +28,9 @@ class Application
 		void					update(sf::Time dt);
 		void					render();
 
+		void					runHeadless();
 		void					updateStatistics(sf::Time dt);
+		void					updateSoakReport(sf::Time tickTime);
 		void					registerStates();
 
 
@@ -39,11 +44,19 @@ class Application
 
 		MusicPlayer			mMusic;
 		SoundPlayer			mSounds;
+		std::unique_ptr<Autopilot>	mAutopilot;
+		bool					mHeadless;
 		StateStack			mStateStack;
 
 		sf::Text				mStatisticsText;
 		sf::Time				mStatisticsUpdateTime;
 		std::size_t			mStatisticsNumFrames;
+
+		sf::Time				mReportSimulatedTime;
+		sf::Time				mReportTickTime;
+		sf::Time				mReportMaxTickTime;
+		std::size_t			mReportNumTicks;
+		sf::Time				mTotalSimulatedTime;
 };
 
 #endif // APPLICATION_HPP
@@ -0,0 +1,76 @@
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+
+#include "Player.hpp"
+#include "Aircraft.hpp"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+#include <array>
+
+
+class World;
+class CommandQueue;
+
+// Computer player for unattended test runs. It takes the place of the keyboard and
+// steers player 1 through the same action commands: dodging enemy bullets and
+// aircraft, collecting pickups and firing all the time.
+class Autopilot : private sf::NonCopyable
+{
+public:
+	// Enemy aircraft updates per detail level since the last call to takeDetailCounts()
+	typedef std::array<std::size_t, Aircraft::DetailLevelCount> DetailCounts;
+
+
+public:
+	explicit				Autopilot(std::size_t runs);
+
+	void					handleRealtimeInput(const World& world, CommandQueue& commands);
+
+	bool					startRun();
+	std::size_t			getStartedRuns() const;
+
+	std::size_t			getEntityCount() const;
+	std::size_t			getParticleCount() const;
+	std::size_t			getBulletCount() const;
+	sf::Time				takeMaxBulletUpdateTime();
+	DetailCounts			takeDetailCounts();
+
+
+private:
+	struct Threat
+	{
+		sf::Vector2f		position;
+		sf::Vector2f		velocity;
+		float				radius;
+	};
+
+
+private:
+	Player::ActionSet		steer(const Aircraft& aircraft, sf::Time dt);
+	float				rateMove(sf::Vector2f direction, const Aircraft& aircraft) const;
+
+
+private:
+	Player				mPilot;
+	std::vector<Threat>		mThreats;
+	std::vector<sf::Vector2f>	mPickups;
+	sf::FloatRect			mViewBounds;
+	float				mLastViewTop;
+	sf::Vector2f			mScrollVelocity;
+	sf::Time				mMissileCooldown;
+
+	std::size_t			mRuns;
+	std::size_t			mStartedRuns;
+	std::size_t			mEntityCount;
+	std::size_t			mParticleCount;
+	std::size_t			mBulletCount;
+	sf::Time				mMaxBulletUpdateTime;
+	DetailCounts			mDetailCounts;
+};
+
+#endif // AUTOPILOT_HPP
@@ -0,0 +1,55 @@
+#ifndef BEHAVIOR_HPP
+#define BEHAVIOR_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <vector>
+
+
+struct Direction;
+
+// One instruction of an enemy behavior script. Directions are turned into unit vectors
+// when the script is built, so running it never needs any trigonometry.
+struct BehaviorStep
+{
+	enum Op
+	{
+		Move,
+		Wait,
+		FireBurst,
+		WaitUntilPlayerNear,
+	};
+
+	BehaviorStep();
+
+	Op						op;
+	sf::Vector2f			direction;
+	float					distance;
+	sf::Time				duration;
+	int						count;
+};
+
+// Scripts loop, like the direction lists they replace
+typedef std::vector<BehaviorStep> BehaviorScript;
+
+namespace Behavior
+{
+	// Fly the given distance, the angle is measured like in Direction
+	BehaviorStep			move(float angle, float distance);
+	BehaviorStep			moveBy(sf::Vector2f offset);
+
+	// Hover in place
+	BehaviorStep			wait(sf::Time duration);
+
+	// Fire count shots, one every interval, while flying on
+	BehaviorStep			fireBurst(int count, sf::Time interval);
+
+	// Keep flying until a player comes within the radius
+	BehaviorStep			waitUntilPlayerNear(float radius);
+
+	BehaviorScript			fromDirections(const std::vector<Direction>& directions);
+	bool					hasFireBursts(const BehaviorScript& script);
+}
+
+#endif // BEHAVIOR_HPP
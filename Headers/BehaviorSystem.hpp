@@ -0,0 +1,64 @@
+#ifndef BEHAVIORSYSTEM_HPP
+#define BEHAVIORSYSTEM_HPP
+
+#include "Behavior.hpp"
+#include "TimerWheel.hpp"
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <vector>
+
+
+class Aircraft;
+
+// Runs behavior scripts as resumable frames. A frame only holds the position in its script
+// and is resumed by the timer wheel on the tick its current step is over, so an enemy
+// flying a long leg costs nothing until it has to change course. Frames are pooled and
+// recycled, starting a script never allocates once the pool has grown.
+class BehaviorSystem : private sf::NonCopyable
+{
+public:
+	typedef std::size_t		Frame;
+
+	static const Frame		NoFrame;
+
+
+public:
+							BehaviorSystem(TimerWheel& timers, const std::vector<Aircraft*>& players);
+
+	// A delay of zero runs the first step right away
+	Frame					start(Aircraft& aircraft, const BehaviorScript& script, std::size_t step = 0, TimerWheel::Tick delay = 0, int burstShots = 0);
+	void					stop(Frame frame);
+
+	std::size_t				getStep(Frame frame) const;
+	TimerWheel::Tick		getRemainingTicks(Frame frame) const;
+	int						getBurstShots(Frame frame) const;
+	std::size_t				getRunningCount() const;
+
+
+private:
+	struct ScriptFrame
+	{
+		Aircraft*				aircraft;
+		const BehaviorScript*	script;
+		std::size_t				step;
+		int						burstShots;
+		TimerWheel::ID			timer;
+	};
+
+
+private:
+	void					resume(Frame frame);
+	void					suspend(Frame frame, TimerWheel::Tick ticks);
+	void					advance(ScriptFrame& frame);
+	bool					isPlayerNear(const Aircraft& aircraft, float radius) const;
+
+
+private:
+	TimerWheel&						mTimers;
+	const std::vector<Aircraft*>&		mPlayers;
+	std::vector<ScriptFrame>			mFrames;
+	std::vector<Frame>				mFreeFrames;
+};
+
+#endif // BEHAVIORSYSTEM_HPP
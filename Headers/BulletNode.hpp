@@ -0,0 +1,107 @@
+#ifndef BULLETNODE_HPP
+#define BULLETNODE_HPP
+
+#include "SceneNode.hpp"
+#include "ResourceIdentifiers.hpp"
+#include "Projectile.hpp"
+
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <array>
+#include <vector>
+
+
+class Aircraft;
+struct BulletPatternData;
+struct BulletState;
+
+// Store for all unguided bullets: the aircraft guns and the boss patterns. Thousands of them
+// are alive at a time, so instead of one Projectile node each they are kept in parallel
+// arrays per side, moved in one vectorized loop per tick, culled and tested in bulk and drawn
+// as a single vertex array. Like particles, they are stored in world coordinates.
+// Guided missiles stay Projectile nodes.
+//
+// Frame budget with 5000 live bullets: UpdateBudget (0.5 ms, 3% of a 60 Hz frame) for the
+// movement pass, and the same again for filling the vertex array. The soak test report
+// prints the slowest update and flags it when it goes over.
+class BulletNode : public SceneNode
+{
+public:
+	enum Side
+	{
+		Allied,
+		Enemy,
+		SideCount
+	};
+
+	static const sf::Time	UpdateBudget;
+
+	// Bullets are numbered apart from the entities, spectators see both in one list
+	static const sf::Uint32	FirstBulletId;
+
+
+public:
+							BulletNode(const TextureHolder& textures, const std::vector<Aircraft*>& players);
+
+	// Flies at the projectile type's speed
+	void					addBullet(Projectile::Type type, sf::Vector2f position, sf::Vector2f direction);
+
+	// Emits every shot the pattern fires between the two points of the pattern's clock
+	void					firePattern(const BulletPatternData& pattern, sf::Vector2f origin, sf::Time from, sf::Time to);
+
+	void					removeOutside(const sf::FloatRect& bounds);
+
+	// Removes the bullets of one side hitting the rectangle, returns their total damage
+	int						removeHits(Side side, const sf::FloatRect& bounds);
+
+	std::size_t				getBulletCount() const;
+	std::size_t				getBulletCount(Side side) const;
+	sf::Vector2f			getBulletPosition(Side side, std::size_t index) const;
+	sf::Vector2f			getBulletVelocity(Side side, std::size_t index) const;
+	sf::Time				getUpdateTime() const;
+
+	void					saveState(std::vector<BulletState>& bullets, sf::Uint32& nextBulletId) const;
+	void					loadState(const std::vector<BulletState>& bullets, sf::Uint32 nextBulletId);
+
+	virtual unsigned int	getCategory() const;
+	virtual void			translateOrigin(sf::Vector2f offset);
+
+
+private:
+	struct Bullets
+	{
+		std::vector<float>			positionX;
+		std::vector<float>			positionY;
+		std::vector<float>			directionX;
+		std::vector<float>			directionY;
+		std::vector<float>			speed;
+		std::vector<sf::Uint8>		type;
+		std::vector<sf::Uint32>		id;
+	};
+
+
+private:
+	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
+	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+
+	void					addBullet(Projectile::Type type, sf::Vector2f position, sf::Vector2f direction, float speed, sf::Uint32 id);
+	void					removeBullet(Bullets& bullets, std::size_t index);
+	sf::Vector2f			getAimTarget(sf::Vector2f origin) const;
+	void					computeVertices() const;
+
+	static Side				getSide(Projectile::Type type);
+
+
+private:
+	const sf::Texture&					mTexture;
+	const std::vector<Aircraft*>&			mPlayers;
+	std::array<Bullets, SideCount>		mBullets;
+	sf::Uint32							mNextBulletId;
+	sf::Time							mUpdateTime;
+
+	mutable sf::VertexArray				mVertexArray;
+	mutable bool						mNeedsVertexUpdate;
+};
+
+#endif // BULLETNODE_HPP
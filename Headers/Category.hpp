@@ -17,6 +17,10 @@ namespace Category
 		EnemyProjectile	= 1 << 6,
 		ParticleSystem		= 1 << 7,
 		SoundEffect		= 1 << 8,
+		BulletSystem		= 1 << 9,
+		Swarm				= 1 << 10,
+		ExplosionSystem	= 1 << 11,
+		TrailSystem		= 1 << 12,
 
 		Aircraft = PlayerAircraft | AlliedAircraft | EnemyAircraft,
 		Projectile = AlliedProjectile | EnemyProjectile,
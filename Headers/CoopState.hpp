@@ -0,0 +1,30 @@
+#ifndef COOPSTATE_HPP
+#define COOPSTATE_HPP
+
+#include "State.hpp"
+#include "World.hpp"
+#include "Player.hpp"
+
+#include <SFML/Graphics/Text.hpp>
+
+
+// Two players at one keyboard, each watching the world through an own half of the screen
+class CoopState : public State
+{
+public:
+	CoopState(StateStack& stack, Context context);
+
+	virtual void		draw();
+	virtual bool		update(sf::Time dt);
+	virtual bool		handleEvent(const sf::Event& event);
+
+
+private:
+	World			mWorld;
+	Player			mFirstPlayer;
+	Player			mSecondPlayer;
+
+	sf::Text			mScoreText;
+};
+
+#endif // COOPSTATE_HPP
@@ -2,6 +2,7 @@
 #define DATATABLES_HPP
 
 #include "ResourceIdentifiers.hpp"
+#include "Behavior.hpp"
 
 #include <SFML/System/Time.hpp>
 #include <SFML/Graphics/Color.hpp>
@@ -25,6 +26,40 @@ struct Direction
 	float distance;
 };
 
+// One stream source of a bullet pattern. It fires every interval while the pattern's
+// clock is within [begin, end) of the cycle, turning by spin degrees per second
+struct BulletEmitter
+{
+	BulletEmitter(float angle, float spread, int streams, float speed, float spin, sf::Time interval, sf::Time begin, sf::Time end, bool aimed)
+	: angle(angle)
+	, spread(spread)
+	, streams(streams)
+	, speed(speed)
+	, spin(spin)
+	, interval(interval)
+	, begin(begin)
+	, end(end)
+	, aimed(aimed)
+	{
+	}
+
+	float angle;
+	float spread;
+	int streams;
+	float speed;
+	float spin;
+	sf::Time interval;
+	sf::Time begin;
+	sf::Time end;
+	bool aimed;
+};
+
+struct BulletPatternData
+{
+	sf::Time						cycle;
+	std::vector<BulletEmitter>		emitters;
+};
+
 struct AircraftData
 {
 	int					          hitpoints;
@@ -33,6 +68,8 @@ struct AircraftData
 	sf::IntRect					textureRect;
 	sf::Time						fireInterval;
 	std::vector<Direction>			directions;
+	BehaviorScript					behavior;
+	BulletPatternData				bulletPattern;
 	bool							hasRollAnimation;
 };
 
@@ -55,6 +92,10 @@ struct ParticleData
 {
 	sf::Color						color;
 	sf::Time						lifetime;
+	float							drag;
+	std::size_t						capacity;
+	std::size_t						budget;
+	float							emissionRate;
 };
 
 
@@ -3,26 +3,33 @@
 
 #include "SceneNode.hpp"
 #include "Particle.hpp"
+#include "TimerWheel.hpp"
+#include "ParticleRegistry.hpp"
 
 
 class ParticleNode;
 
+// Emits into the particle system of its type, behind the carrier it is attached to. The carrier may sit in a
+// formation, so its world transform is looked up on the first emission of a tick and kept until the next update.
 class EmitterNode : public SceneNode
 {
 public:
-	explicit				EmitterNode(Particle::Type type);
+							EmitterNode(Particle::Type type, const SceneNode& carrier, TimerWheel& timers, ParticleRegistry& particles);
+	virtual				~EmitterNode();
 
 
 private:
 	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
-
-	void					emitParticles(sf::Time dt);
+	void					emitParticles();
 
 
 private:
-	sf::Time				mAccumulatedTime;
-	Particle::Type			mType;
+	const SceneNode&		mCarrier;
+	TimerWheel&			mTimers;
+	TimerWheel::ID			mEmissionTimer;
 	ParticleNode*			mParticleSystem;
+	sf::Transform			mCarrierTransform;
+	bool					mNeedsCarrierTransform;
 };
 
 #endif // EMITTERNODE_HPP
@@ -0,0 +1,46 @@
+#ifndef ENDLESSGENERATOR_HPP
+#define ENDLESSGENERATOR_HPP
+
+#include "LevelFormat.hpp"
+
+#include <random>
+#include <vector>
+
+
+// Procedural enemy waves for endless mode. The scroll is cut into chunks of fixed
+// height, and every chunk is generated from the seed and its index alone: a run can
+// be replayed from its seed, and any chunk can be generated again after a rollback.
+class EndlessGenerator
+{
+public:
+	static const float		ChunkHeight;
+
+
+public:
+	explicit				EndlessGenerator(unsigned long seed);
+
+	// Fills spawns with the enemies of one chunk, sorted by distance from the chunk's lower edge
+	void					generateChunk(std::size_t index, std::vector<LevelFormat::Spawn>& spawns) const;
+	unsigned long			getSeed() const;
+
+
+private:
+	enum Formation
+	{
+		Row,
+		Vee,
+		Columns,
+		Diagonal,
+		FormationCount
+	};
+
+
+private:
+	void					addWave(std::mt19937& random, float distance, float difficulty, std::vector<LevelFormat::Spawn>& spawns) const;
+
+
+private:
+	unsigned long			mSeed;
+};
+
+#endif // ENDLESSGENERATOR_HPP
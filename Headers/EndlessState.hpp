@@ -0,0 +1,36 @@
+#ifndef ENDLESSSTATE_HPP
+#define ENDLESSSTATE_HPP
+
+#include "State.hpp"
+#include "World.hpp"
+#include "Player.hpp"
+
+#include <SFML/Graphics/Text.hpp>
+
+#include <string>
+
+
+// One run through procedurally generated waves that ends only when the player is shot down
+class EndlessState : public State
+{
+public:
+	EndlessState(StateStack& stack, Context context);
+
+	virtual void		draw();
+	virtual bool		update(sf::Time dt);
+	virtual bool		handleEvent(const sf::Event& event);
+
+
+private:
+	static unsigned long	loadSeed(const std::string& filename);
+
+
+private:
+	World			mWorld;
+	Player&			mPlayer;
+
+	sf::Text			mScoreText;
+	sf::Text			mSeedText;
+};
+
+#endif // ENDLESSSTATE_HPP
@@ -4,6 +4,8 @@
 #include "SceneNode.hpp"
 
 
+struct EntityState;
+
 class Entity : public SceneNode
 {
 public:
@@ -22,14 +24,28 @@ public:
 	virtual void		remove();
 	virtual bool		isDestroyed() const;
 
+	sf::Uint32			getEntityId() const;
+	virtual void		saveState(EntityState& state) const;
+	virtual void		loadState(const EntityState& state);
+
+	static sf::Uint32	getNextEntityId();
+	static void		setNextEntityId(sf::Uint32 id);
+
 
 protected:
+	// Pooled entities are built without an ID (0), respawn() gives them the next one
+						Entity(int hitpoints, sf::Uint32 id);
+	void				respawn(int hitpoints);
+
 	virtual void		updateCurrent(sf::Time dt, CommandQueue& commands);
 
 
 private:
+	sf::Uint32			mEntityId;
 	sf::Vector2f		mVelocity;
 	int				mHitpoints;
+
+	static sf::Uint32	mNextEntityId;
 };
 
 #endif // ENTITY_HPP
@@ -0,0 +1,56 @@
+#ifndef EXPLOSIONNODE_HPP
+#define EXPLOSIONNODE_HPP
+
+#include "SceneNode.hpp"
+#include "ResourceIdentifiers.hpp"
+#include "AnimationClip.hpp"
+#include "Snapshot.hpp"
+
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <vector>
+
+
+// Plays the explosions of all destroyed aircraft, which are removed from the scene as soon as they hand
+// off their position. All of them play the same clip, so an explosion is only a position and the time it
+// started, and all of them are drawn as a single vertex array. Like particles, they are stored in world coordinates.
+class ExplosionNode : public SceneNode
+{
+public:
+	explicit				ExplosionNode(const AnimationHolder& animations);
+
+	void					addExplosion(sf::Vector2f position);
+	std::size_t			getExplosionCount() const;
+
+	void					saveState(std::vector<ExplosionState>& explosions) const;
+	void					loadState(const std::vector<ExplosionState>& explosions);
+
+	virtual unsigned int	getCategory() const;
+	virtual void			translateOrigin(sf::Vector2f offset);
+
+
+private:
+	struct Explosion
+	{
+		sf::Vector2f		position;
+		sf::Time			startTime;
+	};
+
+
+private:
+	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
+	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+
+	void					computeVertices() const;
+
+
+private:
+	const AnimationClip&		mClip;
+	std::vector<Explosion>		mExplosions;
+	sf::Time					mElapsedTime;
+
+	mutable sf::VertexArray	mVertexArray;
+	mutable bool				mNeedsVertexUpdate;
+};
+
+#endif // EXPLOSIONNODE_HPP
@@ -0,0 +1,50 @@
+#ifndef FORMATIONNODE_HPP
+#define FORMATIONNODE_HPP
+
+#include "SceneNode.hpp"
+#include "Aircraft.hpp"
+
+#include <SFML/Config.hpp>
+
+
+struct FormationState;
+
+// Group of enemies flying one movement pattern together. The members are children at
+// fixed offsets, so the pattern is evaluated once for the whole group. When the leader
+// is shot down, the formation breaks and the members continue on their own.
+class FormationNode : public SceneNode
+{
+public:
+	typedef std::unique_ptr<Aircraft> AircraftPtr;
+
+
+public:
+							FormationNode(const Aircraft& leader, Aircraft::Type pattern);
+	explicit				FormationNode(const FormationState& state);
+
+	void					addMember(AircraftPtr member);
+	void					release(SceneNode& layer);
+
+	sf::Uint32				getId() const;
+	bool					isBroken() const;
+	bool					isEmpty() const;
+	virtual bool			isMarkedForRemoval() const;
+
+	void					saveState(FormationState& state) const;
+
+
+private:
+	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
+	void					updateVelocity();
+
+
+private:
+	sf::Uint32				mLeaderId;
+	sf::Vector2f			mVelocity;
+	float					mSpeed;
+	Aircraft::Type			mPattern;
+	std::size_t				mDirectionIndex;
+	float					mTravelledDistance;
+};
+
+#endif // FORMATIONNODE_HPP
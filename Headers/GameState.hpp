@@ -4,6 +4,7 @@
 #include "State.hpp"
 #include "World.hpp"
 #include "Player.hpp"
+#include "SpectatorPublisher.hpp"
 
 #include <SFML/Graphics/Text.hpp>
 
@@ -27,7 +28,9 @@ private:
 	sf::Int64           mScore;
 	sf::Text			mLevelText;
 	bool				mShowText;
-	sf::Time			mTextEffectTime;
+
+	SpectatorPublisher	mPublisher;
+	sf::Text			mPublisherText;
 };
 
 #endif // GAMESTATE_HPP
\ No newline at end of file
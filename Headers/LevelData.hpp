@@ -0,0 +1,43 @@
+#ifndef LEVELDATA_HPP
+#define LEVELDATA_HPP
+
+#include "LevelFormat.hpp"
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <string>
+
+
+// Read-only view of a binary level file. The file is memory-mapped instead of read,
+// so loading a level costs a validation pass and no copying or sorting.
+class LevelData : private sf::NonCopyable
+{
+public:
+								LevelData();
+								~LevelData();
+
+	void							loadFromFile(const std::string& filename);
+
+	std::size_t					getSpawnCount() const;
+	const LevelFormat::Spawn*		getSpawns() const;
+	const LevelFormat::Spawn&		getSpawn(std::size_t index) const;
+
+
+private:
+	void							map(const std::string& filename);
+	void							unmap();
+
+
+private:
+	const char*					mData;
+	std::size_t					mSize;
+	const LevelFormat::Spawn*		mSpawns;
+	std::size_t					mSpawnCount;
+
+#ifdef _WIN32
+	void*						mFile;
+	void*						mMapping;
+#endif
+};
+
+#endif // LEVELDATA_HPP
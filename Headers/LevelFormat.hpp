@@ -0,0 +1,41 @@
+#ifndef LEVELFORMAT_HPP
+#define LEVELFORMAT_HPP
+
+#include <cstdint>
+
+
+// Layout of the binary level files, shared by the game and Tools/LevelConverter.
+// A header is followed by the enemy spawns, sorted by ascending distance. All
+// values are stored little-endian, so the file can be mapped and used in place.
+namespace LevelFormat
+{
+	const char			Magic[4] = { 'A', 'J', 'L', 'V' };
+	const std::uint32_t	Version = 1;
+
+	// Pattern value for enemies that fly the movement pattern of their own type
+	const std::uint8_t	OwnPattern = 0xff;
+
+	// Type value for a drone swarm instead of a single aircraft
+	const std::uint8_t	SwarmType = 0xfe;
+
+	struct Header
+	{
+		char				magic[4];
+		std::uint32_t		version;
+		std::uint32_t		spawnCount;
+	};
+
+	struct Spawn
+	{
+		float			distance;	// Scrolled distance from the player's start at which the enemy is placed
+		float			x;			// Horizontal offset from the player's start
+		std::uint8_t		type;		// Aircraft::Type, or SwarmType
+		std::uint8_t		pattern;	// Aircraft::Type whose movement pattern is flown, or OwnPattern
+		std::uint16_t		count;		// Number of drones in a swarm, 0 for aircraft
+	};
+
+	static_assert(sizeof(Header) == 12, "LevelFormat::Header must not be padded");
+	static_assert(sizeof(Spawn) == 12, "LevelFormat::Spawn must not be padded");
+}
+
+#endif // LEVELFORMAT_HPP
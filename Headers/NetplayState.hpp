@@ -0,0 +1,56 @@
+#ifndef NETPLAYSTATE_HPP
+#define NETPLAYSTATE_HPP
+
+#include "State.hpp"
+#include "World.hpp"
+#include "Player.hpp"
+#include "NetworkLink.hpp"
+#include "RollbackSession.hpp"
+
+#include <SFML/Graphics/Text.hpp>
+
+#include <string>
+
+
+// Two players on linked machines sharing one world, kept in sync by rollback
+class NetplayState : public State
+{
+public:
+	NetplayState(StateStack& stack, Context context);
+
+	virtual void		draw();
+	virtual bool		update(sf::Time dt);
+	virtual bool		handleEvent(const sf::Event& event);
+
+
+private:
+	struct Settings
+	{
+		Settings();
+
+		int				player;
+		std::string		remoteAddress;
+		unsigned short	port;
+		sf::Time		latency;
+		float			loss;
+	};
+
+
+private:
+	static Settings		loadSettings(const std::string& filename);
+	void				updateStatistics();
+
+
+private:
+	Settings			mSettings;
+	World			mWorld;
+	Player			mLocalPlayer;
+	Player			mRemotePlayer;
+	NetworkLink		mLink;
+	RollbackSession	mSession;
+
+	sf::Text			mScoreText;
+	sf::Text			mStatisticsText;
+};
+
+#endif // NETPLAYSTATE_HPP
@@ -0,0 +1,53 @@
+#ifndef NETWORKLINK_HPP
+#define NETWORKLINK_HPP
+
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <deque>
+#include <random>
+
+
+// Unreliable, non-blocking datagram link to a single remote peer.
+// Latency and packet loss can be simulated on the sending side, to test netplay over loopback.
+class NetworkLink : private sf::NonCopyable
+{
+public:
+	NetworkLink();
+
+	bool						bind(unsigned short localPort);
+	void						setRemote(const sf::IpAddress& address, unsigned short port);
+
+	void						setSimulatedLatency(sf::Time latency);
+	void						setSimulatedLoss(float probability);
+
+	void						send(const sf::Packet& packet);
+	bool						receive(sf::Packet& packet);
+	void						update();
+
+
+private:
+	struct PendingPacket
+	{
+		sf::Time				sendTime;
+		sf::Packet			packet;
+	};
+
+
+private:
+	sf::UdpSocket				mSocket;
+	sf::IpAddress				mRemoteAddress;
+	unsigned short			mRemotePort;
+
+	sf::Clock					mClock;
+	sf::Time					mLatency;
+	float					mLoss;
+	std::deque<PendingPacket>	mOutgoing;
+	std::default_random_engine	mLossEngine;
+};
+
+#endif // NETWORKLINK_HPP
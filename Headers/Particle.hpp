@@ -1,11 +1,7 @@
 #ifndef PARTICLE_HPP
 #define PARTICLE_HPP
 
-#include <SFML/System/Vector2.hpp>
-#include <SFML/System/Time.hpp>
-#include <SFML/Graphics/Color.hpp>
-
-
+// Particles themselves live in a ParticleBuffer, everything shared by one type is in its ParticleData
 struct Particle 
 {
 	enum Type
@@ -14,10 +10,6 @@ struct Particle
 		Smoke,
 		ParticleCount
 	};
-
-	sf::Vector2f	position;
-	sf::Color		color;
-	sf::Time		lifetime;
 };
 
 #endif // PARTICLE_HPP
@@ -0,0 +1,35 @@
+#ifndef PARTICLEBUDGET_HPP
+#define PARTICLEBUDGET_HPP
+
+#include "Particle.hpp"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+
+// Decides how fast emitters may emit. Every particle type has a global budget, emitters close to the
+// view get the larger share of it, and all rates are scaled back while frames take too long.
+// Emitters that get no share simply pause, so running out of budget never costs frame time.
+class ParticleBudget : private sf::NonCopyable
+{
+public:
+							ParticleBudget();
+
+	void					setViewBounds(const sf::FloatRect& bounds);
+	void					setFrameTime(sf::Time frameTime);
+
+	float					getEmissionRate(Particle::Type type, sf::Vector2f position, std::size_t particleCount) const;
+	float					getQuality() const;
+
+
+private:
+	float					getPriority(sf::Vector2f position) const;
+
+
+private:
+	sf::FloatRect			mViewBounds;
+	float					mQuality;
+};
+
+#endif // PARTICLEBUDGET_HPP
@@ -0,0 +1,49 @@
+#ifndef PARTICLEBUFFER_HPP
+#define PARTICLEBUFFER_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Config.hpp>
+
+#include <vector>
+
+
+// Fixed-capacity ring buffer of particles, stored as one array per attribute so that the update
+// runs as a vectorized kernel. Particles expire in the order they were added, which holds as long as
+// all of them live equally long; once the buffer is full, a new particle replaces the oldest one.
+// Disjoint ranges of particles may be integrated on different threads.
+class ParticleBuffer
+{
+public:
+	explicit				ParticleBuffer(std::size_t capacity);
+
+	void					add(sf::Vector2f position, sf::Vector2f velocity, float lifetime);
+	void					update(float seconds, float drag);
+	void					integrate(std::size_t begin, std::size_t end, float seconds, float drag);
+	void					removeExpired();
+	void					translate(sf::Vector2f offset);
+	void					clear();
+
+	std::size_t			getSize() const;
+	std::size_t			getCapacity() const;
+	sf::Uint64				getAddedCount() const;
+	bool					hasMovingParticles() const;
+
+	// Index 0 is the oldest particle, its slot is where it is stored in the ring
+	std::size_t			getSlot(std::size_t index) const;
+	sf::Vector2f			getPosition(std::size_t index) const;
+	float					getLifetime(std::size_t index) const;
+
+
+private:
+	std::vector<float>		mPositionX;
+	std::vector<float>		mPositionY;
+	std::vector<float>		mVelocityX;
+	std::vector<float>		mVelocityY;
+	std::vector<float>		mLifetime;
+	std::size_t			mHead;
+	std::size_t			mSize;
+	sf::Uint64				mAddedCount;
+	sf::Uint64				mLastMoving;
+};
+
+#endif // PARTICLEBUFFER_HPP
@@ -4,37 +4,55 @@
 #include "SceneNode.hpp"
 #include "ResourceIdentifiers.hpp"
 #include "Particle.hpp"
+#include "ParticleBuffer.hpp"
+#include "WorkerPool.hpp"
+#include "ParticleBudget.hpp"
 
-#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Shader.hpp>
 
-#include <deque>
+#include <vector>
 
 
 class ParticleNode : public SceneNode
 {
 public:
-	ParticleNode(Particle::Type type, const TextureHolder& textures);
+	ParticleNode(Particle::Type type, const TextureHolder& textures, ShaderHolder& shaders, WorkerPool& workers,
+		const ParticleBudget& budget);
 
-	void					addParticle(sf::Vector2f position);
+	void					addParticle(sf::Vector2f position, sf::Vector2f velocity = sf::Vector2f());
+	float					getEmissionRate(sf::Vector2f position) const;
 	Particle::Type			getParticleType() const;
+	std::size_t				getParticleCount() const;
 	virtual unsigned int	getCategory() const;
+	virtual void			translateOrigin(sf::Vector2f offset);
 
 
 private:
 	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
 	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
 
-	void					addVertex(float worldX, float worldY, float texCoordX, float texCoordY, const sf::Color& color) const;
-	void					computeVertices() const;
+	void					writePoint(std::size_t index, sf::Vertex& point) const;
+	void					writeQuad(std::size_t index, sf::Vertex* quad) const;
+	void					writeVertices(std::size_t begin, std::size_t end, sf::Vertex* vertices) const;
+	std::size_t			getVerticesPerParticle() const;
+	void					updateVertices() const;
 
 
 private:
-	std::deque<Particle>	mParticles;
-	const sf::Texture&		mTexture;
-	Particle::Type			mType;
-
-	mutable sf::VertexArray	mVertexArray;
-	mutable bool			mNeedsVertexUpdate;
+	ParticleBuffer				mParticles;
+	const sf::Texture&			mTexture;
+	sf::Shader*				mShader;
+	WorkerPool&				mWorkers;
+	const ParticleBudget&		mBudget;
+	Particle::Type				mType;
+	sf::Time					mElapsedTime;
+
+	// With the shader there is one point sprite per ring buffer slot, otherwise one quad
+	mutable std::vector<sf::Vertex>	mVertices;
+	mutable sf::Uint64			mWrittenCount;
+	mutable bool				mNeedsVertexUpdate;
+	mutable bool				mNeedsFullUpdate;
 };
 
 #endif // PARTICLENODE_HPP
@@ -0,0 +1,33 @@
+#ifndef PARTICLEREGISTRY_HPP
+#define PARTICLEREGISTRY_HPP
+
+#include "Particle.hpp"
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <array>
+
+
+class ParticleNode;
+class TrailNode;
+
+// The particle system of every type in the scene and the missile trails, so that emitters and missiles can
+// bind to theirs when they are created instead of searching the scene graph for it
+class ParticleRegistry : private sf::NonCopyable
+{
+public:
+							ParticleRegistry();
+
+	void					add(ParticleNode& system);
+	ParticleNode*			get(Particle::Type type) const;
+
+	void					setTrails(TrailNode& trails);
+	TrailNode*				getTrails() const;
+
+
+private:
+	std::array<ParticleNode*, Particle::ParticleCount>	mSystems;
+	TrailNode*											mTrails;
+};
+
+#endif // PARTICLEREGISTRY_HPP
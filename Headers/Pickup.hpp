@@ -32,9 +32,12 @@ public:
 
 	void 				apply(Aircraft& player) const;
 
+	virtual void			saveState(EntityState& state) const;
+
 
 protected:
 	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual bool			batchCurrent(SpriteBatch& batch, const sf::Transform& transform) const;
 
 
 private:
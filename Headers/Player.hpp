@@ -4,6 +4,7 @@
 #include "Command.hpp"
 
 #include <SFML/Window/Event.hpp>
+#include <SFML/Config.hpp>
 
 #include <map>
 
@@ -32,27 +33,38 @@ public:
 	};
 
 
+	// One bit per action, small enough to be sent over the network every frame
+	typedef sf::Uint8 ActionSet;
+
+
 public:
-	Player();
+	explicit				Player(int identifier = 1);
 
 	void					handleEvent(const sf::Event& event, CommandQueue& commands);
 	void					handleRealtimeInput(CommandQueue& commands);
 
+	ActionSet				getEventActions(const sf::Event& event) const;
+	ActionSet				getRealtimeActions() const;
+	void					applyActions(ActionSet actions, CommandQueue& commands);
+	int					getIdentifier() const;
+
 	void					assignKey(Action action, sf::Keyboard::Key key);
 	sf::Keyboard::Key		getAssignedKey(Action action) const;
 
 	void 				setMissionStatus(MissionStatus status);
 	MissionStatus 			getMissionStatus() const;
 
+	static bool			isRealtimeAction(Action action);
+
 private:
 	void					initializeActions();
-	static bool			isRealtimeAction(Action action);
 
 
 private:
 	std::map<sf::Keyboard::Key, Action>		mKeyBinding;
 	std::map<Action, Command>				mActionBinding;
 	MissionStatus 							mCurrentMissionStatus;
+	int										mIdentifier;
 };
 
 #endif // PLAYER_HPP
@@ -3,6 +3,8 @@
 
 #include "Entity.hpp"
 #include "ResourceIdentifiers.hpp"
+#include "ParticleRegistry.hpp"
+#include "TrailNode.hpp"
 
 #include <SFML/Graphics/Sprite.hpp>
 
@@ -15,12 +17,13 @@ public:
 		AlliedBullet,
 		EnemyBullet,
 		Missile,
+		PatternBullet,
 		TypeCount
 	};
 
 
 public:
-	Projectile(Type type, const TextureHolder& textures);
+	Projectile(Type type, const TextureHolder& textures, ParticleRegistry& particles);
 
 	void					guideTowards(sf::Vector2f position);
 	bool					isGuided() const;
@@ -30,16 +33,22 @@ public:
 	float				getMaxSpeed() const;
 	int					getDamage() const;
 
+	virtual void			saveState(EntityState& state) const;
+	virtual void			loadState(const EntityState& state);
+
 
 private:
 	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
 	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual bool			batchCurrent(SpriteBatch& batch, const sf::Transform& transform) const;
 
 
 private:
 	Type					mType;
 	sf::Sprite			mSprite;
 	sf::Vector2f			mTargetDirection;
+	TrailNode*				mTrails;
+	TrailNode::ID			mTrail;
 };
 
 #endif // PROJECTILE_HPP
@@ -17,6 +17,9 @@ public:
 	template <typename Parameter>
 	void						load(Identifier id, const std::string& filename, const Parameter& secondParam);
 
+	// For resources that are built in code rather than loaded from a file
+	void						insert(Identifier id, std::unique_ptr<Resource> resource);
+
 	Resource&					get(Identifier id);
 	const Resource&			get(Identifier id) const;
 
@@ -11,6 +11,8 @@ namespace sf
 	class SoundBuffer;
 }
 
+class AnimationClip;
+
 namespace Textures
 {
 	enum ID
@@ -29,6 +31,14 @@ namespace Textures
 	};
 }
 
+namespace Animations
+{
+	enum ID
+	{
+		Explosion,
+	};
+}
+
 namespace Shaders
 {
 	enum ID
@@ -37,6 +47,7 @@ namespace Shaders
 		DownSamplePass,
 		GaussianBlurPass,
 		AddPass,
+		ParticlePass,
 	};
 }
 
@@ -85,5 +96,6 @@ typedef ResourceHolder<sf::Texture, Textures::ID>			TextureHolder;
 typedef ResourceHolder<sf::Font, Fonts::ID>					FontHolder;
 typedef ResourceHolder<sf::Shader, Shaders::ID>				ShaderHolder;
 typedef ResourceHolder<sf::SoundBuffer, SoundEffect::ID>	SoundBufferHolder;
+typedef ResourceHolder<AnimationClip, Animations::ID>		AnimationHolder;
 
 #endif // RESOURCEIDENTIFIERS_HPP
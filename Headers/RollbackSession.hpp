@@ -0,0 +1,104 @@
+#ifndef ROLLBACKSESSION_HPP
+#define ROLLBACKSESSION_HPP
+
+#include "Player.hpp"
+#include "Snapshot.hpp"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Config.hpp>
+
+#include <array>
+
+
+class World;
+class NetworkLink;
+class SoundPlayer;
+
+// Drives a World shared by a local and a remote player. The remote player's actions are
+// predicted, and once the real ones arrive and differ, the world is rewound to the frame
+// of the misprediction and simulated forward again.
+class RollbackSession : private sf::NonCopyable
+{
+public:
+	static const sf::Int32		MaxRollbackFrames = 8;
+
+
+public:
+	RollbackSession(World& world, Player& localPlayer, Player& remotePlayer, NetworkLink& link, SoundPlayer& sounds);
+
+	void						addLocalActions(Player::ActionSet actions);
+	void						update(sf::Time dt);
+
+	sf::Int32					getFrame() const;
+	sf::Int32					getConfirmedFrame() const;
+	bool						isConfirmed() const;
+	bool						isStalled() const;
+	bool						isDesynced() const;
+
+	std::size_t				getRollbackCount() const;
+	sf::Int32					getLastRollbackLength() const;
+	sf::Time					getLastRollbackTime() const;
+	sf::Time					getMaxRollbackTime() const;
+
+
+private:
+	enum
+	{
+		InputBufferSize	= 64,
+		SnapshotCount		= MaxRollbackFrames + 2,
+	};
+
+	struct FrameChecksum
+	{
+		FrameChecksum();
+
+		sf::Int32				frame;
+		sf::Uint32			checksum;
+	};
+
+	typedef std::array<Player::ActionSet, InputBufferSize>	InputBuffer;
+	typedef std::array<FrameChecksum, InputBufferSize>		ChecksumBuffer;
+
+
+private:
+	sf::Int32					receiveInputs();
+	void						rollback(sf::Int32 frame, sf::Time dt);
+	void						simulate(sf::Int32 frame, sf::Time dt);
+	void						sendInputs();
+
+	Player::ActionSet			predictRemoteActions() const;
+	void						recordChecksums();
+	void						compareChecksum(sf::Int32 frame);
+
+
+private:
+	World&						mWorld;
+	Player&					mLocalPlayer;
+	Player&					mRemotePlayer;
+	NetworkLink&				mLink;
+	SoundPlayer&				mSounds;
+
+	sf::Int32					mFrame;
+	sf::Int32					mConfirmedFrame;
+	sf::Int32					mRemoteAckFrame;
+	Player::ActionSet			mPendingActions;
+	Player::ActionSet			mRealtimeMask;
+	bool						mStalled;
+
+	InputBuffer				mLocalInputs;
+	InputBuffer				mRemoteInputs;
+	std::array<WorldSnapshot, SnapshotCount>	mSnapshots;
+
+	ChecksumBuffer				mLocalChecksums;
+	ChecksumBuffer				mRemoteChecksums;
+	sf::Int32					mLastChecksumFrame;
+	bool						mDesynced;
+
+	std::size_t				mRollbackCount;
+	sf::Int32					mLastRollbackLength;
+	sf::Time					mLastRollbackTime;
+	sf::Time					mMaxRollbackTime;
+};
+
+#endif // ROLLBACKSESSION_HPP
@@ -7,15 +7,18 @@
 #include <SFML/System/Time.hpp>
 #include <SFML/Graphics/Transformable.hpp>
 #include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
 
 #include <vector>
 #include <set>
 #include <memory>
 #include <utility>
+#include <functional>
 
 
 struct Command;
 class CommandQueue;
+class SpriteBatch;
 
 class SceneNode : public sf::Transformable, public sf::Drawable
 {
@@ -23,6 +26,16 @@ public:
 	typedef std::unique_ptr<SceneNode> Ptr;
 	typedef std::pair<SceneNode*, SceneNode*> Pair;
 
+	// A node to draw, together with the transform it would have received from draw() and the layer it is in
+	struct DrawCommand
+	{
+		const SceneNode*	node;
+		sf::Transform		transform;
+		const SceneNode*	layer;
+	};
+
+	typedef std::vector<DrawCommand> DrawList;
+
 
 public:
 	explicit				SceneNode(Category::Type category = Category::None);
@@ -32,6 +45,15 @@ public:
 
 	void					update(sf::Time dt, CommandQueue& commands);
 
+	void					sortChildren(const std::function<bool(const SceneNode&, const SceneNode&)>& less);
+
+	void					collectDrawLists(const std::vector<sf::FloatRect>& viewRects, std::vector<DrawList>& drawLists) const;
+	static void			drawList(const DrawList& list, sf::RenderTarget& target, SpriteBatch& batch,
+								sf::RenderStates states = sf::RenderStates::Default);
+
+	void					translateChildren(sf::Vector2f offset);
+	virtual void			translateOrigin(sf::Vector2f offset);
+
 	sf::Vector2f			getWorldPosition() const;
 	sf::Transform			getWorldTransform() const;
 
@@ -40,20 +62,27 @@ public:
 
 	void					checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs);
 	void					checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs);
-	void					removeWrecks();
+	void					removeWrecks(std::vector<Ptr>& wrecks);
 	virtual sf::FloatRect	getBoundingRect() const;
 	virtual bool			isMarkedForRemoval() const;
 	virtual bool			isDestroyed() const;
 
 
+protected:
+	const std::vector<Ptr>&	getChildren() const;
+
+
 private:
 	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
 	void					updateChildren(sf::Time dt, CommandQueue& commands);
 
 	virtual void			draw(sf::RenderTarget& target, sf::RenderStates states) const;
 	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+	virtual bool			batchCurrent(SpriteBatch& batch, const sf::Transform& transform) const;
 	void					drawChildren(sf::RenderTarget& target, sf::RenderStates states) const;
 	void					drawBoundingRect(sf::RenderTarget& target, sf::RenderStates states) const;
+	void					collectVisible(const std::vector<sf::FloatRect>& viewRects, std::vector<DrawList>& drawLists,
+								sf::Transform transform, unsigned int viewMask, const SceneNode* layer) const;
 
 
 private:
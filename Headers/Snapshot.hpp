@@ -0,0 +1,134 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Config.hpp>
+
+#include <vector>
+#include <random>
+
+
+// Plain copy of one entity's simulation state, used to save and restore the world
+struct EntityState
+{
+	enum Kind
+	{
+		AircraftEntity,
+		ProjectileEntity,
+		PickupEntity,
+	};
+
+	EntityState();
+
+	sf::Uint32				id;
+	sf::Uint8				kind;
+	sf::Uint8				type;
+	sf::Vector2f			position;
+	sf::Vector2f			velocity;
+	float					rotation;
+	int						hitpoints;
+
+	// Aircraft only
+	int						identifier;
+	sf::Uint32				formation;
+	int						fireRateLevel;
+	int						spreadLevel;
+	int						missileAmmo;
+	int						speed;
+	sf::Uint8				movementPattern;
+	bool					hasBehavior;
+	sf::Uint32				behaviorStep;
+	sf::Uint32				behaviorDelay;
+	int						burstShots;
+	bool					isFiringBurstShot;
+	sf::Time				patternTime;
+	sf::Time				fireCooldown;
+	sf::Uint32				updateCounter;
+	sf::Uint8				detailLevel;
+	sf::Time				skippedTime;
+	bool					showExplosion;
+	bool					playedExplosionSound;
+	bool					spawnedPickup;
+
+	// Projectile only
+	sf::Vector2f			targetDirection;
+};
+
+// Shared movement of a formation, its members store their offsets from it
+struct FormationState
+{
+	FormationState();
+
+	sf::Uint32				id;
+	sf::Vector2f			position;
+	sf::Vector2f			velocity;
+	float					speed;
+	sf::Uint8				pattern;
+	sf::Uint32				directionIndex;
+	float					travelledDistance;
+};
+
+// One bullet of the bullet store
+struct BulletState
+{
+	BulletState();
+
+	sf::Uint32				id;
+	sf::Uint8				type;
+	sf::Vector2f			position;
+	sf::Vector2f			direction;
+	float					speed;
+};
+
+// One drone of a swarm
+struct DroneState
+{
+	DroneState();
+
+	sf::Vector2f			position;
+	sf::Vector2f			velocity;
+	int						hitpoints;
+};
+
+struct SwarmState
+{
+	std::vector<DroneState>	drones;
+};
+
+// An explosion that is still playing, it is purely cosmetic
+struct ExplosionState
+{
+	ExplosionState();
+
+	sf::Vector2f			position;
+	sf::Time				age;
+};
+
+// Everything World needs to rewind the simulation to an earlier tick
+struct WorldSnapshot
+{
+	WorldSnapshot();
+
+	sf::Uint32					frame;
+	double						originOffset;
+	sf::Vector2f				viewCenter;
+	std::size_t					spawnChunk;
+	sf::Vector2f				chunkOrigin;
+	std::size_t					nextSpawnPoint;
+	sf::Uint32					nextEntityId;
+	sf::Uint32					nextBulletId;
+	sf::Int64					score;
+	sf::Time					playerExplosionTime;
+	std::default_random_engine	randomEngine;
+	std::vector<EntityState>	entities;
+	std::vector<FormationState>	formations;
+	std::vector<BulletState>	bullets;
+	std::vector<SwarmState>		swarms;
+	std::vector<ExplosionState>	explosions;
+};
+
+// Hash of the gameplay-relevant part of a snapshot, used to detect desyncs
+sf::Uint32 computeChecksum(const WorldSnapshot& snapshot);
+
+#endif // SNAPSHOT_HPP
@@ -20,7 +20,11 @@ class SoundPlayer : private sf::NonCopyable
 		void						play(SoundEffect::ID effect);
 		void						play(SoundEffect::ID effect, sf::Vector2f position);
 
+		void						setMuted(bool muted);
+		std::size_t				getSoundCount() const;
+
 		void						removeStoppedSounds();
+		void						translateSounds(sf::Vector2f offset);
 		void						setListenerPosition(sf::Vector2f position);
 		sf::Vector2f				getListenerPosition() const;
 
@@ -28,6 +32,7 @@ class SoundPlayer : private sf::NonCopyable
 	private:
 		SoundBufferHolder			mSoundBuffers;
 		std::list<sf::Sound>		mSounds;
+		bool						mMuted;
 };
 
 #endif // SOUNDPLAYER_HPP
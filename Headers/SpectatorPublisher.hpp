@@ -0,0 +1,57 @@
+#ifndef SPECTATORPUBLISHER_HPP
+#define SPECTATORPUBLISHER_HPP
+
+#include "NetworkLink.hpp"
+#include "SpectatorStream.hpp"
+#include "Snapshot.hpp"
+
+#include <SFML/Network/Packet.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+
+class World;
+
+// Streams the world to a spectator viewer, within a fixed bandwidth budget.
+// Ticks the budget can't afford are skipped; the next frame is encoded against the last one sent.
+class SpectatorPublisher : private sf::NonCopyable
+{
+public:
+	SpectatorPublisher();
+
+	bool						isEnabled() const;
+	void						update(sf::Time dt, World& world);
+
+	std::size_t				getBytesPerSecond() const;
+	std::size_t				getFramesPerSecond() const;
+	sf::Time					getAverageEncodeTime() const;
+	sf::Time					getMaxEncodeTime() const;
+
+
+private:
+	void						updateStatistics(sf::Time dt);
+
+
+private:
+	NetworkLink				mLink;
+	SpectatorEncoder			mEncoder;
+	WorldSnapshot				mSnapshot;
+	sf::Packet				mPacket;
+	bool						mEnabled;
+
+	float					mBudget;
+	float					mAllowance;
+	sf::Time					mSinceKeyframe;
+
+	sf::Time					mStatisticsUpdateTime;
+	std::size_t				mStatisticsBytes;
+	std::size_t				mStatisticsFrames;
+	sf::Time					mStatisticsEncodeTime;
+	sf::Time					mStatisticsMaxEncodeTime;
+	std::size_t				mBytesPerSecond;
+	std::size_t				mFramesPerSecond;
+	sf::Time					mAverageEncodeTime;
+	sf::Time					mMaxEncodeTime;
+};
+
+#endif // SPECTATORPUBLISHER_HPP
@@ -0,0 +1,44 @@
+#ifndef SPECTATORSTATE_HPP
+#define SPECTATORSTATE_HPP
+
+#include "State.hpp"
+#include "NetworkLink.hpp"
+#include "SpectatorStream.hpp"
+#include "ResourceHolder.hpp"
+#include "ResourceIdentifiers.hpp"
+#include "DataTables.hpp"
+
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include <vector>
+
+
+// Draws a game streamed by a SpectatorPublisher, without simulating anything itself
+class SpectatorState : public State
+{
+public:
+	SpectatorState(StateStack& stack, Context context);
+
+	virtual void				draw();
+	virtual bool				update(sf::Time dt);
+	virtual bool				handleEvent(const sf::Event& event);
+
+
+private:
+	NetworkLink				mLink;
+	SpectatorDecoder			mDecoder;
+	sf::Time					mSinceLastFrame;
+
+	TextureHolder				mTextures;
+	std::vector<AircraftData>	mAircraftTable;
+	std::vector<ProjectileData>	mProjectileTable;
+	std::vector<PickupData>		mPickupTable;
+
+	sf::Sprite				mBackground;
+	sf::Sprite				mEntitySprite;
+	sf::Text					mScoreText;
+	sf::Text					mStatusText;
+};
+
+#endif // SPECTATORSTATE_HPP
@@ -0,0 +1,99 @@
+#ifndef SPECTATORSTREAM_HPP
+#define SPECTATORSTREAM_HPP
+
+#include <SFML/Network/Packet.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Config.hpp>
+
+#include <vector>
+
+
+struct WorldSnapshot;
+
+// Entity as seen by spectators: only what is needed to draw it, in fixed point
+struct SpectatorEntity
+{
+	SpectatorEntity();
+
+	sf::Uint32				id;
+	sf::Uint8				kind;
+	sf::Uint8				type;
+	sf::Int16				x;
+	sf::Int16				y;
+	sf::Uint8				rotation;
+	sf::Int16				hitpoints;
+};
+
+// Everything a spectator draws in one tick, entities sorted by ID
+struct SpectatorFrame
+{
+	SpectatorFrame();
+
+	sf::Uint32						tick;
+	sf::Uint8						level;
+	sf::Int16						viewX;
+	sf::Int16						viewY;
+	sf::Int32						scroll;
+	sf::Int64						score;
+	std::vector<SpectatorEntity>	entities;
+};
+
+// Fixed point conversions shared by both ends of the stream
+sf::Int16		quantizePosition(float value);
+float			dequantizePosition(sf::Int16 value);
+sf::Uint8		quantizeRotation(float degrees);
+float			dequantizeRotation(sf::Uint8 value);
+
+// Writes each frame as the difference to the previously written one.
+// Keyframes carry everything, for spectators joining late or after a lost packet.
+class SpectatorEncoder
+{
+public:
+	SpectatorEncoder();
+
+	void							encode(const WorldSnapshot& snapshot, sf::Uint8 level, sf::Packet& packet);
+	void							requestKeyframe();
+
+
+private:
+	struct Change
+	{
+		std::size_t					current;
+		std::size_t					previous;
+		sf::Uint8					mask;
+	};
+
+
+private:
+	void							quantize(const WorldSnapshot& snapshot, sf::Uint8 level);
+	void							writeChange(const Change& change, sf::Packet& packet) const;
+
+
+private:
+	SpectatorFrame					mPrevious;
+	SpectatorFrame					mCurrent;
+	std::vector<Change>				mChanges;
+	std::vector<sf::Uint32>			mRemoved;
+	sf::Uint32						mTick;
+	bool							mKeyframe;
+};
+
+// Rebuilds the frames written by a SpectatorEncoder
+class SpectatorDecoder
+{
+public:
+	SpectatorDecoder();
+
+	bool							decode(sf::Packet& packet);
+	bool							isSynchronized() const;
+	const SpectatorFrame&			getFrame() const;
+
+
+private:
+	SpectatorFrame					mFrame;
+	SpectatorFrame					mNext;
+	std::vector<sf::Uint32>			mRemoved;
+	bool							mSynchronized;
+};
+
+#endif // SPECTATORSTREAM_HPP
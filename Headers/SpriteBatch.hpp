@@ -0,0 +1,44 @@
+#ifndef SPRITEBATCH_HPP
+#define SPRITEBATCH_HPP
+
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <vector>
+
+
+namespace sf
+{
+	class Sprite;
+	class Texture;
+	class RenderTarget;
+}
+
+// Collects sprites as quads, one vertex array per texture, and draws each array with a single call.
+// The arrays keep their memory from frame to frame.
+class SpriteBatch : private sf::NonCopyable
+{
+public:
+							SpriteBatch();
+
+	void					draw(const sf::Sprite& sprite, const sf::Transform& transform);
+	void					flush(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default);
+
+	std::size_t			getSpriteCount() const;
+
+
+private:
+	struct Batch
+	{
+		const sf::Texture*	texture;
+		sf::VertexArray		vertices;
+	};
+
+
+private:
+	std::vector<Batch>		mBatches;
+	std::size_t			mUsedBatches;
+};
+
+#endif // SPRITEBATCH_HPP
@@ -19,6 +19,7 @@ class StateStack;
 class Player;
 class MusicPlayer;
 class SoundPlayer;
+class Autopilot;
 
 class State
 {
@@ -28,7 +29,7 @@ class State
 		struct Context
 		{
 			Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, Player& player,
-									MusicPlayer& music, SoundPlayer& sounds);
+									MusicPlayer& music, SoundPlayer& sounds, Autopilot* autopilot);
 
 			sf::RenderWindow*	window;
 			TextureHolder*		textures;
@@ -36,6 +37,7 @@ class State
 			Player*			player;
 			MusicPlayer*		music;
 			SoundPlayer*		sounds;
+			Autopilot*			autopilot;
 		};
 
 
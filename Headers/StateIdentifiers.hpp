@@ -13,7 +13,11 @@ namespace States
 		Loading,
 		Pause,
 		Settings,
-		GameOver
+		GameOver,
+		Netplay,
+		Spectator,
+		Coop,
+		Endless
 	};
 }
 
@@ -0,0 +1,89 @@
+#ifndef SWARMNODE_HPP
+#define SWARMNODE_HPP
+
+#include "SceneNode.hpp"
+#include "ResourceIdentifiers.hpp"
+
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+
+
+class Aircraft;
+class BulletNode;
+struct SwarmState;
+
+// Swarm of small drones chasing the players with boids-style cohesion, separation and
+// alignment. Hundreds of drones don't fit the one-node-per-aircraft update and collision
+// paths, so they live in packed arrays: neighbors are looked up in a uniform grid, the
+// steering is one vectorized pass over all drones, and the swarm is drawn with a single
+// vertex array. Like particles, drones are stored in world coordinates.
+class SwarmNode : public SceneNode
+{
+public:
+							SwarmNode(const TextureHolder& textures, const std::vector<Aircraft*>& players);
+
+	// Scatters the drones on a disc around the center, flying down the screen
+	void					addDrones(sf::Vector2f center, std::size_t count);
+
+	// Bullets and players hitting drones, returns the number of drones shot down
+	std::size_t				handleCollisions(BulletNode& bullets);
+	void					removeOutside(const sf::FloatRect& bounds);
+
+	std::size_t				getDroneCount() const;
+	sf::Vector2f			getDronePosition(std::size_t index) const;
+	sf::Vector2f			getDroneVelocity(std::size_t index) const;
+
+	void					saveState(SwarmState& state) const;
+	void					loadState(const SwarmState& state);
+
+	virtual unsigned int	getCategory() const;
+	virtual bool			isMarkedForRemoval() const;
+	virtual void			translateOrigin(sf::Vector2f offset);
+
+
+private:
+	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
+	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+
+	void					buildGrid();
+	void					gatherNeighbors();
+	sf::Vector2f			getTarget() const;
+	sf::FloatRect			getDroneRect(std::size_t index) const;
+	void					removeDrone(std::size_t index);
+	void					computeVertices() const;
+
+
+private:
+	const sf::Texture&				mTexture;
+	const std::vector<Aircraft*>&		mPlayers;
+
+	// Drone state
+	std::vector<float>				mPositionX;
+	std::vector<float>				mPositionY;
+	std::vector<float>				mVelocityX;
+	std::vector<float>				mVelocityY;
+	std::vector<int>				mHitpoints;
+
+	// Per-tick neighborhood averages, input of the steering pass
+	std::vector<float>				mCenterX;
+	std::vector<float>				mCenterY;
+	std::vector<float>				mHeadingX;
+	std::vector<float>				mHeadingY;
+	std::vector<float>				mSeparationX;
+	std::vector<float>				mSeparationY;
+
+	// Uniform grid, drone indices sorted by cell
+	sf::Vector2f					mGridOrigin;
+	std::size_t					mGridColumns;
+	std::size_t					mGridRows;
+	std::vector<std::size_t>			mCellStart;
+	std::vector<std::size_t>			mCellDrones;
+	std::vector<std::size_t>			mDroneCells;
+
+	mutable sf::VertexArray			mVertexArray;
+	mutable bool					mNeedsVertexUpdate;
+};
+
+#endif // SWARMNODE_HPP
@@ -0,0 +1,83 @@
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Config.hpp>
+
+#include <array>
+#include <vector>
+#include <functional>
+
+
+// Hierarchical timing wheel driven by the fixed simulation tick.
+// Scheduling and cancelling are O(1), and advancing a tick only touches the
+// timers expiring in it (plus an amortized cascade from the coarser wheels).
+class TimerWheel : private sf::NonCopyable
+{
+public:
+	typedef std::function<void()>	Callback;
+	typedef sf::Uint64				Tick;
+	typedef sf::Uint64				ID;
+
+	static const ID				InvalidID = 0;
+	static const sf::Time			TickLength;
+
+
+public:
+	TimerWheel();
+
+	ID						schedule(sf::Time delay, Callback callback);
+	ID						scheduleAt(Tick tick, Callback callback);
+	void						cancel(ID id);
+	bool						isPending(ID id) const;
+	Tick						getRemainingTicks(ID id) const;
+
+	void						update(sf::Time dt);
+	void						advance();
+
+	Tick						getCurrentTick() const;
+	sf::Time					getCurrentTime() const;
+	std::size_t				getPendingCount() const;
+
+	static Tick				toTicks(sf::Time time);
+
+
+private:
+	enum
+	{
+		LevelBits		= 6,
+		SlotsPerLevel	= 1 << LevelBits,
+		LevelCount		= 4,
+		SlotCount		= SlotsPerLevel * LevelCount,
+	};
+
+	struct Timer
+	{
+		Callback				callback;
+		Tick					expiry;
+		sf::Uint32			generation;
+		std::size_t			slot;
+		std::size_t			prev;
+		std::size_t			next;
+	};
+
+
+private:
+	void						insert(std::size_t index);
+	void						unlink(std::size_t index);
+	void						release(std::size_t index);
+	void						cascade(std::size_t level);
+	void						expire(std::size_t slot);
+
+
+private:
+	std::vector<Timer>					mTimers;
+	std::vector<std::size_t>				mFreeList;
+	std::array<std::size_t, SlotCount>	mSlots;
+	Tick								mCurrentTick;
+	sf::Time							mAccumulatedTime;
+	std::size_t						mPendingCount;
+};
+
+#endif // TIMERWHEEL_HPP
@@ -2,6 +2,7 @@
 #define TITLESTATE_HPP
 
 #include "State.hpp"
+#include "TimerWheel.hpp"
 
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Text.hpp>
@@ -17,12 +18,16 @@ public:
 	virtual bool		handleEvent(const sf::Event& event);
 
 
+private:
+	void				toggleText();
+
+
 private:
 	sf::Sprite		mBackgroundSprite;
 	sf::Text			mText;
 
 	bool				mShowText;
-	sf::Time			mTextEffectTime;
+	TimerWheel		mTimers;
 };
 
 #endif // TITLESTATE_HPP
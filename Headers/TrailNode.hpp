@@ -0,0 +1,69 @@
+#ifndef TRAILNODE_HPP
+#define TRAILNODE_HPP
+
+#include "SceneNode.hpp"
+
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <array>
+#include <vector>
+
+
+// Smoke trails of the guided missiles. Every missile feeds its position into a short ring buffer once per
+// tick, and each trail is drawn as a ribbon that fades out with the age of its points. All ribbons are
+// joined by degenerate triangles into a single strip, so they take one draw call.
+// A trail that is no longer fed fades out on its own and its slot is reused afterwards.
+class TrailNode : public SceneNode
+{
+public:
+	typedef sf::Uint32 ID;
+
+	static const ID			InvalidID;
+
+
+public:
+							TrailNode();
+
+	ID						addTrail();
+	void					extendTrail(ID id, sf::Vector2f position);
+	std::size_t			getPointCount(ID id) const;
+	std::size_t			getTrailCount() const;
+
+	virtual unsigned int	getCategory() const;
+	virtual void			translateOrigin(sf::Vector2f offset);
+
+
+private:
+	static const std::size_t	PointCount = 16;
+
+	struct Trail
+	{
+		std::array<sf::Vector2f, PointCount>	positions;
+		std::array<sf::Time, PointCount>		times;
+		std::size_t							head;
+		std::size_t							size;
+		sf::Time								addTime;
+		sf::Uint32								generation;
+		bool									isActive;
+	};
+
+
+private:
+	virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
+	virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+
+	bool					isLive(ID id) const;
+	void					computeVertices() const;
+	void					appendRibbon(const Trail& trail) const;
+
+
+private:
+	std::vector<Trail>			mTrails;
+	std::vector<std::size_t>	mFreeSlots;
+	sf::Time					mElapsedTime;
+
+	mutable sf::VertexArray	mVertexArray;
+	mutable bool				mNeedsVertexUpdate;
+};
+
+#endif // TRAILNODE_HPP
@@ -5,6 +5,7 @@
 #include <SFML/System/Vector2.hpp>
 
 #include <sstream>
+#include <random>
 
 
 namespace sf
@@ -13,8 +14,6 @@ namespace sf
 	class Text;
 }
 
-class Animation;
-
 // Since std::to_string doesn't work on MinGW we have to implement
 // our own to support all platforms.
 template <typename T>
@@ -29,7 +28,6 @@ std::string		toString(sf::Keyboard::Key key);
 // Call setOrigin() with the center of the object
 void			centerOrigin(sf::Sprite& sprite);
 void			centerOrigin(sf::Text& text);
-void			centerOrigin(Animation& animation);
 
 // Degree/radian conversion
 float			toDegree(float radian);
@@ -37,6 +35,7 @@ float			toRadian(float degree);
 
 // Random number generation
 int				randomInt(int exclusiveMax);
+std::default_random_engine&	getRandomEngine();
 
 // Vector operations
 float			length(sf::Vector2f vector);
@@ -0,0 +1,42 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+// Splits a loop over [0, count) into chunks, one per worker thread plus one for the calling thread,
+// which returns once all of them are done. On a single core there are no workers, and loops too
+// small to fill two chunks run on the calling thread alone, so both behave like a serial loop.
+class WorkerPool : private sf::NonCopyable
+{
+public:
+	typedef std::function<void(std::size_t begin, std::size_t end)> Task;
+
+
+public:
+	explicit				WorkerPool(std::size_t threadCount = getDefaultThreadCount());
+
+	void					run(std::size_t count, std::size_t minChunkSize, const Task& task);
+	std::size_t			getThreadCount() const;
+
+	static std::size_t		getDefaultThreadCount();
+
+
+private:
+	void					runChunk(std::size_t chunk);
+
+
+private:
+	// Launching and waiting for a thread orders its chunk with the loop, so no mutex is needed
+	std::vector<std::unique_ptr<sf::Thread>>	mThreads;
+	const Task*									mTask;
+	std::size_t								mCount;
+	std::size_t								mChunkSize;
+};
+
+#endif // WORKERPOOL_HPP
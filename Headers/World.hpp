@@ -10,10 +10,21 @@
 #include "Command.hpp"
 #include "BloomEffect.hpp"
 #include "SoundPlayer.hpp"
+#include "TimerWheel.hpp"
+#include "BehaviorSystem.hpp"
+#include "AircraftPool.hpp"
+#include "WorkerPool.hpp"
+#include "ParticleBudget.hpp"
+#include "ParticleRegistry.hpp"
+#include "AnimationClip.hpp"
+#include "SpriteBatch.hpp"
+#include "LevelData.hpp"
+#include "EndlessGenerator.hpp"
 
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/Graphics/View.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Shader.hpp>
 
 #include <array>
 #include <queue>
@@ -25,15 +36,39 @@ namespace sf
 	class RenderTarget;
 }
 
+struct EntityState;
+struct WorldSnapshot;
+class FormationNode;
+class BulletNode;
+class ExplosionNode;
+
 class World : private sf::NonCopyable
 {
 public:
-	World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sounds);
+	enum Mode
+	{
+		Campaign,
+		Endless,
+	};
+
+
+public:
+	World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sounds, Mode mode = Campaign, unsigned long seed = 0);
 	void								update(sf::Time dt);
 	void								draw();
+	void								setSplitScreen(bool enabled);
 
 	CommandQueue&						getCommandQueue();
+	TimerWheel&						getTimers();
 
+	Aircraft*							addAircraft(int identifier);
+	Aircraft*							getAircraft(int identifier) const;
+
+	void								saveState(WorldSnapshot& snapshot);
+	void								loadState(const WorldSnapshot& snapshot);
+
+	sf::FloatRect						getViewBounds() const;
+	unsigned long						getSeed() const;
 	bool 							hasAlivePlayer() const;
 	bool 							hasPlayerReachedEnd() const;
 	static int                              getLevel();
@@ -47,15 +82,26 @@ private:
 	void								adaptPlayerVelocity();
 	void								handleCollisions();
 	void								updateSounds();
+	void								updateViews();
+	void								drawViews(sf::RenderTarget& target);
+	void								rebaseOrigin();
+	void								translateWorld(sf::Vector2f offset);
+	void								removePlayerWrecks(sf::Time dt);
+	void								removeWrecks();
+	Entity*							createEntity(const EntityState& state);
 
 	void							     buildScene();
-	void								addEnemies();
-	void								addEnemy(Aircraft::Type type, float relX, float relY);
+	void								prefetchEnemies();
 	void								spawnEnemies();
+	std::size_t						spawnGroup(const LevelFormat::Spawn* spawns, std::size_t count, std::size_t first, sf::Vector2f origin);
+	std::unique_ptr<Aircraft>			createEnemy(const LevelFormat::Spawn& spawn, sf::Vector2f origin);
+	void								updateFormations();
+	void								startChunk(std::size_t index);
+	void								scrollBackground();
 	void								destroyEntitiesOutsideView();
 	void								guideMissiles();
+	void								updateDetailLevels();
 	void                                    updateScore(sf::Time dt);
-	sf::FloatRect						getViewBounds() const;
 	sf::FloatRect						getBattlefieldBounds() const;
 
 
@@ -65,21 +111,20 @@ private:
 		Background,
 		LowerAir,
 		UpperAir,
+		Explosions,
 		LayerCount
 	};
 
-	struct SpawnPoint
+	struct Collider
 	{
-		SpawnPoint(Aircraft::Type type, float x, float y)
-			: type(type)
-			, x(x)
-			, y(y)
+		Collider(SceneNode* node, sf::FloatRect bounds)
+			: node(node)
+			, bounds(bounds)
 		{
 		}
 
-		Aircraft::Type type;
-		float x;
-		float y;
+		SceneNode* node;
+		sf::FloatRect bounds;
 	};
 
 
@@ -87,11 +132,25 @@ private:
 	sf::RenderTarget&					mTarget;
 	sf::RenderTexture					mSceneTexture;
 	sf::View							mWorldView;
+	bool								mSplitScreen;
+	std::vector<sf::View>				mViews;
+	std::vector<sf::FloatRect>			mViewRects;
+	std::vector<SceneNode::DrawList>		mDrawLists;
 
 	TextureHolder						mTextures;
+	ShaderHolder						mShaders;
+	AnimationHolder						mAnimations;
+	SpriteBatch							mSpriteBatch;
 	FontHolder&						mFonts;
 	SoundPlayer&						mSounds;
 
+	WorkerPool						mWorkers;
+	ParticleBudget					mParticleBudget;
+	ParticleRegistry				mParticleSystems;
+	sf::Time						mFrameWorkTime;
+	TimerWheel						mTimers;
+	BehaviorSystem					mBehaviors;
+	AircraftPool						mEnemyPool;
 	SceneNode							mSceneGraph;
 	std::array<SceneNode*, LayerCount>	     mSceneLayers;
 	CommandQueue						mCommandQueue;
@@ -99,10 +158,26 @@ private:
 	sf::FloatRect						mWorldBounds;
 	sf::Vector2f						mSpawnPosition;
 	float							mScrollSpeed;
-	Aircraft*					          mPlayerAircraft;
-
-	std::vector<SpawnPoint>				mEnemySpawnPoints;
+	std::vector<Aircraft*>				mPlayerAircrafts;
+	sf::Time							mPlayerExplosionTime;
+	double							mOriginOffset;
+
+	Mode								mMode;
+	LevelData							mLevelData;
+	EndlessGenerator					mGenerator;
+	std::vector<LevelFormat::Spawn>		mChunkSpawns;
+	std::size_t						mChunkIndex;
+	sf::Vector2f						mChunkOrigin;
+	std::size_t						mNextSpawnPoint;
+	std::size_t						mPrefetchPoint;
+	SceneNode*						mBackground;
+	float							mBackgroundTileHeight;
+	BulletNode*						mBullets;
+	ExplosionNode*					mExplosions;
 	std::vector<Aircraft*>				mActiveEnemies;
+	std::vector<FormationNode*>			mFormations;
+	std::vector<Collider>				mColliders;
+	std::vector<SceneNode::Ptr>			mWrecks;
 
 	BloomEffect						mBloomEffect;
 	static int                              mLevel;
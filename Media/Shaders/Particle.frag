@@ -0,0 +1,8 @@
+#version 120
+
+uniform sampler2D texture;
+
+void main()
+{
+	gl_FragColor = gl_Color * texture2D(texture, gl_PointCoord);
+}
@@ -0,0 +1,21 @@
+#version 120
+
+uniform float time;
+uniform float lifetime;
+uniform float size;
+uniform vec4 color;
+
+// Timestamps are whole milliseconds, wrapped at 2^24 so that they fit the colour bytes
+const float TimeRange = 16777216.0;
+
+void main()
+{
+	// Every particle is a single point, expanded to a textured sprite of the given size in pixels
+	gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+	gl_PointSize = size;
+
+	// The vertex colour holds the particle's birth time, the fade is computed from its age
+	float birth = dot(floor(gl_Color.rgb * 255.0 + 0.5), vec3(65536.0, 256.0, 1.0));
+	float age = mod(time - birth, TimeRange);
+	gl_FrontColor = vec4(color.rgb, color.a * clamp(1.0 - age / lifetime, 0.0, 1.0));
+}
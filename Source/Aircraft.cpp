@@ -1,4 +1,5 @@
 #include "Aircraft.hpp"
+#include "SpriteBatch.hpp"
 #include "DataTables.hpp"
 #include "Utility.hpp"
 #include "Pickup.hpp"
@@ -6,10 +7,15 @@
 #include "SoundNode.hpp"
 #include "ResourceHolder.hpp"
 #include "World.hpp"
+#include "Snapshot.hpp"
+#include "BulletNode.hpp"
+#include "ExplosionNode.hpp"
+#include "EmitterNode.hpp"
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 
@@ -18,17 +24,44 @@ using namespace std::placeholders;
 namespace
 {
 	const std::vector<AircraftData> Table = initializeAircraftData();
+
+	// Simulation ticks between two updates, per detail level
+	const std::size_t UpdateInterval[Aircraft::DetailLevelCount] = { 1, 2, 6 };
 }
 
-Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts)
-: Entity(Table[type].hitpoints)
+Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts, TimerWheel& timers, BehaviorSystem& behaviors,
+	ParticleRegistry& particles)
+: Aircraft(type, textures, timers, behaviors, particles)
+{
+	createTexts(fonts);
+	spawn();
+}
+
+Aircraft::Aircraft(Type type, const TextureHolder& textures, TimerWheel& timers, BehaviorSystem& behaviors,
+	ParticleRegistry& particles)
+: Entity(Table[type].hitpoints, 0)
 , mType(type)
+, mMovementPattern(type)
 , mSprite(textures.get(Table[type].texture), Table[type].textureRect)
-, mExplosion(textures.get(Textures::Explosion))
 , mFireCommand()
 , mMissileCommand()
-, mFireCountdown(sf::Time::Zero)
+, mTimers(timers)
+, mFireReadyTime(sf::Time::Zero)
+, mFireTimer(TimerWheel::InvalidID)
+, mBehaviors(behaviors)
+, mParticles(particles)
+, mSmoke(nullptr)
+, mBehavior(BehaviorSystem::NoFrame)
+, mDetailLevel(FullDetail)
+, mSkippedTime(sf::Time::Zero)
+, mPatternTime(sf::Time::Zero)
+, mUpdateCounter(0)
+, mIdentifier(0)
+, mFormation(0)
 , mIsFiring(false)
+, mIsGunReady(true)
+, mIsFiringBurstShot(false)
+, mFiresInBursts(false)
 , mIsLaunchingMissile(false)
 , mShowExplosion(true)
 , mPlayedExplosionSound(false)
@@ -38,29 +71,18 @@ Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& f
 , mMissileAmmo(1)
 , mSpeed(0)
 , mDropPickupCommand()
-, mTravelledDistance(0.f)
-, mDirectionIndex(0)
 , mHealthDisplay(nullptr)
 , mMissileDisplay(nullptr)
+, mDisplayedHitpoints(-1)
+, mDisplayedMissiles(-1)
 {
-
-	int level = World::getLevel()-1;
-	mFireRateLevel = Aircraft::Eagle==type ? mPlayerFireRateLevel : (level <= 3 ? level : 2);
-	mSpreadLevel = Aircraft::Eagle==type ? mPlayerSpreadLevel : (level <= 3 ? level : 2);
-	mMissileAmmo = Aircraft::Eagle==type ? mPlayerMissileAmmo : 1;
-
-	mExplosion.setFrameSize(sf::Vector2i(256, 256));
-	mExplosion.setNumFrames(16);
-	mExplosion.setDuration(sf::seconds(1));
-
 	centerOrigin(mSprite);
-	centerOrigin(mExplosion);
 
-	mFireCommand.category = Category::SceneAirLayer;
-	mFireCommand.action   = [this, &textures] (SceneNode& node, sf::Time)
+	mFireCommand.category = Category::BulletSystem;
+	mFireCommand.action   = derivedAction<BulletNode>([this] (BulletNode& bullets, sf::Time)
 	{
-		createBullets(node, textures);
-	};
+		createBullets(bullets);
+	});
 
 	mMissileCommand.category = Category::SceneAirLayer;
 	mMissileCommand.action   = [this, &textures] (SceneNode& node, sf::Time)
@@ -73,7 +95,17 @@ Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& f
 	{
 		createPickup(node, textures);
 	};
+}
+
+Aircraft::~Aircraft()
+{
+	mTimers.cancel(mFireTimer);
+	stopBehavior();
+}
 
+void Aircraft::createTexts(const FontHolder& fonts)
+{
+	// Texts load glyphs into the shared font, which must only happen on the main thread
 	std::unique_ptr<TextNode> healthDisplay(new TextNode(fonts, ""));
 	mHealthDisplay = healthDisplay.get();
 	attachChild(std::move(healthDisplay));
@@ -89,25 +121,77 @@ Aircraft::Aircraft(Type type, const TextureHolder& textures, const FontHolder& f
 	updateTexts();
 }
 
+void Aircraft::spawn()
+{
+	// Start over as a new aircraft, a recycled one must not carry anything over from its previous life
+	despawn();
+	respawn(Table[mType].hitpoints);
+	setPosition(0.f, 0.f);
+	setRotation(0.f);
+
+	int level = World::getLevel()-1;
+	mFireRateLevel = Aircraft::Eagle==mType ? mPlayerFireRateLevel : (level <= 3 ? level : 2);
+	mSpreadLevel = Aircraft::Eagle==mType ? mPlayerSpreadLevel : (level <= 3 ? level : 2);
+	mMissileAmmo = Aircraft::Eagle==mType ? mPlayerMissileAmmo : 1;
+	mSpeed = 0;
+
+	mMovementPattern = mType;
+	mSprite.setTextureRect(Table[mType].textureRect);
+	mDetailLevel = FullDetail;
+	mSkippedTime = sf::Time::Zero;
+	mPatternTime = sf::Time::Zero;
+	mUpdateCounter = getEntityId();
+	mIdentifier = 0;
+	mFormation = 0;
+	mIsFiring = false;
+	mIsFiringBurstShot = false;
+	mIsLaunchingMissile = false;
+	mShowExplosion = true;
+	mPlayedExplosionSound = false;
+	mSpawnedPickup = false;
+
+	updateTexts();
+
+	// Enemies start flying their own pattern, the level may pick another one
+	if (!isAllied())
+		setMovementPattern(mType);
+}
+
+void Aircraft::despawn()
+{
+	// Nothing may keep running for an aircraft that waits in the pool
+	mFireReadyTime = sf::Time::Zero;
+	scheduleGunReady();
+	stopBehavior();
+	stopSmoke();
+}
+
 void Aircraft::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
 {
-	if (isDestroyed() && mShowExplosion)
-		target.draw(mExplosion, states);
-	else
+	// A destroyed aircraft is only around until its explosion has been handed off
+	if (!isDestroyed())
 		target.draw(mSprite, states);
 }
 
-void Aircraft::updateCurrent(sf::Time dt, CommandQueue& commands)
+bool Aircraft::batchCurrent(SpriteBatch& batch, const sf::Transform& transform) const
 {
-	// Update texts and roll animation
-	updateTexts();
-	updateRollAnimation();
+	// A destroyed aircraft is only around until its explosion has been handed off
+	if (!isDestroyed())
+		batch.draw(mSprite, transform);
 
+	return true;
+}
 
+void Aircraft::updateCurrent(sf::Time dt, CommandQueue& commands)
+{
+	updateSmoke();
 
-	// Entity has been destroyed: Possibly drop pickup, mark for removal
+	// Entity has been destroyed: Possibly drop pickup, hand off the explosion, then it is removed.
+	// This happens right away at every detail level
 	if (isDestroyed())
 	{
+		stopBehavior();
+
 		// Update upgrades
 		if (mType == Aircraft::Eagle)
 		{
@@ -117,25 +201,43 @@ void Aircraft::updateCurrent(sf::Time dt, CommandQueue& commands)
 		}
 		
 		checkPickupDrop(commands);
-		mExplosion.update(dt);
 
-		// Play explosion sound only once
+		// Play explosion sound and show the explosion only once
 		if (!mPlayedExplosionSound)
 		{
 			SoundEffect::ID soundEffect = (randomInt(2) == 0) ? SoundEffect::Explosion1 : SoundEffect::Explosion2;
 			playLocalSound(commands, soundEffect);
+			createExplosion(commands);
 
 			mPlayedExplosionSound = true;
 		}
 		return;
 	}
 
+	// Low detail: only simulate every few ticks, integrating the skipped time in one coarse step.
+	// The counter starts at the entity ID, which spreads the updates of different aircraft over the ticks
+	mSkippedTime += dt;
+	if (mUpdateCounter++ % UpdateInterval[mDetailLevel] != 0)
+		return;
+
+	dt = mSkippedTime;
+	mSkippedTime = sf::Time::Zero;
+
+	// Update texts and roll animation, nobody sees them outside the view
+	if (mDetailLevel == FullDetail)
+	{
+		updateTexts();
+		updateRollAnimation();
+	}
+
+
 	// Check if bullets or missiles are fired
 	checkProjectileLaunch(dt, commands);
+	updateBulletPattern(dt, commands);
 
-	// Update enemy movement pattern; apply velocity
-	updateMovementPattern(dt);
-	Entity::updateCurrent(dt, commands);
+	// Apply velocity, the behavior script changes it whenever it resumes. Formation members are moved by their formation
+	if (mFormation == 0)
+		Entity::updateCurrent(dt, commands);
 }
 
 unsigned int Aircraft::getCategory() const
@@ -153,7 +255,14 @@ sf::FloatRect Aircraft::getBoundingRect() const
 
 bool Aircraft::isMarkedForRemoval() const
 {
-	return isDestroyed() && (mExplosion.isFinished() || !mShowExplosion);
+	// The explosion plays on in the ExplosionNode
+	return isDestroyed() && (mPlayedExplosionSound || !mShowExplosion);
+}
+
+bool Aircraft::hasExploded() const
+{
+	// Removed aircraft vanish without an explosion
+	return isDestroyed() && mShowExplosion && mPlayedExplosionSound;
 }
 
 void Aircraft::remove()
@@ -172,6 +281,107 @@ float Aircraft::getMaxSpeed() const
 	return Table[mType].speed + mSpeed;
 }
 
+void Aircraft::setDetailLevel(DetailLevel level)
+{
+	// Returning to full detail: catch up on the skipped time in the next update
+	mDetailLevel = level;
+}
+
+Aircraft::DetailLevel Aircraft::getDetailLevel() const
+{
+	return mDetailLevel;
+}
+
+int Aircraft::getIdentifier() const
+{
+	return mIdentifier;
+}
+
+void Aircraft::setIdentifier(int identifier)
+{
+	mIdentifier = identifier;
+}
+
+void Aircraft::setMovementPattern(Type pattern, std::size_t step, sf::Time delay)
+{
+	mMovementPattern = pattern;
+
+	stopBehavior();
+	if (mFormation == 0)
+		startBehavior(step, delay == sf::Time::Zero ? 0 : TimerWheel::toTicks(delay), 0);
+}
+
+void Aircraft::setFormation(sf::Uint32 formation)
+{
+	// The formation flies the pattern for its members
+	mFormation = formation;
+	if (mFormation != 0)
+		stopBehavior();
+}
+
+sf::Uint32 Aircraft::getFormation() const
+{
+	return mFormation;
+}
+
+void Aircraft::saveState(EntityState& state) const
+{
+	Entity::saveState(state);
+
+	state.kind = EntityState::AircraftEntity;
+	state.type = static_cast<sf::Uint8>(mType);
+	state.identifier = mIdentifier;
+	state.formation = mFormation;
+	state.fireRateLevel = mFireRateLevel;
+	state.spreadLevel = mSpreadLevel;
+	state.missileAmmo = mMissileAmmo;
+	state.speed = mSpeed;
+	state.movementPattern = static_cast<sf::Uint8>(mMovementPattern);
+	state.behaviorStep = (mBehavior != BehaviorSystem::NoFrame) ? static_cast<sf::Uint32>(mBehaviors.getStep(mBehavior)) : 0;
+	state.behaviorDelay = (mBehavior != BehaviorSystem::NoFrame) ? static_cast<sf::Uint32>(mBehaviors.getRemainingTicks(mBehavior)) : 0;
+	state.burstShots = (mBehavior != BehaviorSystem::NoFrame) ? mBehaviors.getBurstShots(mBehavior) : 0;
+	state.hasBehavior = (mBehavior != BehaviorSystem::NoFrame);
+	state.isFiringBurstShot = mIsFiringBurstShot;
+	state.fireCooldown = mFireReadyTime - mTimers.getCurrentTime();
+	state.updateCounter = static_cast<sf::Uint32>(mUpdateCounter);
+	state.detailLevel = static_cast<sf::Uint8>(mDetailLevel);
+	state.skippedTime = mSkippedTime;
+	state.patternTime = mPatternTime;
+	state.showExplosion = mShowExplosion;
+	state.playedExplosionSound = mPlayedExplosionSound;
+	state.spawnedPickup = mSpawnedPickup;
+}
+
+void Aircraft::loadState(const EntityState& state)
+{
+	Entity::loadState(state);
+
+	mIdentifier = state.identifier;
+	mFormation = state.formation;
+	mFireRateLevel = state.fireRateLevel;
+	mSpreadLevel = state.spreadLevel;
+	mMissileAmmo = state.missileAmmo;
+	mSpeed = state.speed;
+	mMovementPattern = static_cast<Type>(state.movementPattern);
+	mIsFiringBurstShot = state.isFiringBurstShot;
+	mUpdateCounter = state.updateCounter;
+	mDetailLevel = static_cast<DetailLevel>(state.detailLevel);
+	mSkippedTime = state.skippedTime;
+	mPatternTime = state.patternTime;
+	mShowExplosion = state.showExplosion;
+	mPlayedExplosionSound = state.playedExplosionSound;
+	mSpawnedPickup = state.spawnedPickup;
+
+	// Cooldowns are stored relative to the tick they were saved in
+	mFireReadyTime = mTimers.getCurrentTime() + state.fireCooldown;
+	scheduleGunReady();
+
+	// The script continues where it was suspended, the velocity it set is part of the entity state
+	stopBehavior();
+	if (state.hasBehavior)
+		startBehavior(state.behaviorStep, std::max<TimerWheel::Tick>(state.behaviorDelay, 1), state.burstShots);
+}
+
 void Aircraft::increaseFireRate()
 {
 	if (mFireRateLevel < 10)
@@ -210,6 +420,11 @@ void Aircraft::fire()
 		mIsFiring = true;
 }
 
+void Aircraft::fireBurstShot()
+{
+	mIsFiringBurstShot = true;
+}
+
 void Aircraft::launchMissile()
 {
 	if (mMissileAmmo > 0)
@@ -235,27 +450,54 @@ void Aircraft::playLocalSound(CommandQueue& commands, SoundEffect::ID effect)
 	commands.push(command);
 }
 
-void Aircraft::updateMovementPattern(sf::Time dt)
+void Aircraft::createExplosion(CommandQueue& commands) const
 {
-	// Enemy airplane: Movement pattern
-	const std::vector<Direction>& directions = Table[mType].directions;
-	if (!directions.empty())
-	{
-		// Moved long enough in current direction: Change direction
-		if (mTravelledDistance > directions[mDirectionIndex].distance)
+	sf::Vector2f worldPosition = getWorldPosition();
+
+	Command command;
+	command.category = Category::ExplosionSystem;
+	command.action = derivedAction<ExplosionNode>(
+		[worldPosition] (ExplosionNode& explosions, sf::Time)
 		{
-			mDirectionIndex = (mDirectionIndex + 1) % directions.size();
-			mTravelledDistance = 0.f;
-		}
+			explosions.addExplosion(worldPosition);
+		});
 
-		// Compute velocity from direction
-		float radians = toRadian(directions[mDirectionIndex].angle + 90.f);
-		float vx = getMaxSpeed() * std::cos(radians);
-		float vy = getMaxSpeed() * std::sin(radians);
+	commands.push(command);
+}
 
-		setVelocity(vx, vy);
+void Aircraft::startBehavior(std::size_t step, TimerWheel::Tick delay, int burstShots)
+{
+	const BehaviorScript& script = Table[mMovementPattern].behavior;
 
-		mTravelledDistance += getMaxSpeed() * dt.asSeconds();
+	mFiresInBursts = Behavior::hasFireBursts(script);
+	mBehavior = mBehaviors.start(*this, script, step, delay, burstShots);
+}
+
+void Aircraft::stopBehavior()
+{
+	mBehaviors.stop(mBehavior);
+	mBehavior = BehaviorSystem::NoFrame;
+	mFiresInBursts = false;
+}
+
+void Aircraft::scheduleGunReady()
+{
+	// The gun gets ready in the first tick at or after the exact time, so the wheel's rounding doesn't shift the next
+	// interval. A gun that is ready already, because a coarse update step overran the interval, needs no timer
+	mTimers.cancel(mFireTimer);
+	mFireTimer = TimerWheel::InvalidID;
+	mIsGunReady = mFireReadyTime <= mTimers.getCurrentTime();
+
+	if (!mIsGunReady)
+	{
+		sf::Int64 tickLength = TimerWheel::TickLength.asMicroseconds();
+		TimerWheel::Tick tick = static_cast<TimerWheel::Tick>((mFireReadyTime.asMicroseconds() + tickLength - 1) / tickLength);
+
+		mFireTimer = mTimers.scheduleAt(tick, [this] ()
+		{
+			mIsGunReady = true;
+			mFireTimer = TimerWheel::InvalidID;
+		});
 	}
 }
 
@@ -269,25 +511,33 @@ void Aircraft::checkPickupDrop(CommandQueue& commands)
 
 void Aircraft::checkProjectileLaunch(sf::Time dt, CommandQueue& commands)
 {
-	// Enemies try to fire all the time
-	if (!isAllied())
+	// Enemies try to fire all the time, unless their script fires in bursts or they have a bullet pattern
+	if (!isAllied() && !mFiresInBursts && Table[mType].bulletPattern.emitters.empty())
 		fire();
 
 	// Check for automatic gunfire, allow only in intervals
-	if (mIsFiring && mFireCountdown <= sf::Time::Zero)
+	sf::Time now = mTimers.getCurrentTime();
+	if (mIsFiring && mIsGunReady)
 	{
 		// Interval expired: We can fire a new bullet
 		commands.push(mFireCommand);
 		playLocalSound(commands, isAllied() ? SoundEffect::AlliedGunfire : SoundEffect::EnemyGunfire);
 
-		mFireCountdown += Table[mType].fireInterval / (mFireRateLevel + 1.f);
-		mIsFiring = false;
+		// The next interval starts when the gun got ready, not now, so the time left over in this update carries
+		// over to the next shot like it did with the countdown. An idle gun carries at most one update step
+		mFireReadyTime = std::max(mFireReadyTime, now - dt) + Table[mType].fireInterval / (mFireRateLevel + 1.f);
+		scheduleGunReady();
 	}
-	else if (mFireCountdown > sf::Time::Zero)
+
+	mIsFiring = false;
+
+	// Burst shots are timed by the behavior script
+	if (mIsFiringBurstShot)
 	{
-		// Interval not expired: Decrease it further
-		mFireCountdown -= dt;
-		mIsFiring = false;
+		commands.push(mFireCommand);
+		playLocalSound(commands, SoundEffect::EnemyGunfire);
+
+		mIsFiringBurstShot = false;
 	}
 
 	// Check for missile launch
@@ -300,32 +550,63 @@ void Aircraft::checkProjectileLaunch(sf::Time dt, CommandQueue& commands)
 	}
 }
 
-void Aircraft::createBullets(SceneNode& node, const TextureHolder& textures) const
+void Aircraft::updateBulletPattern(sf::Time dt, CommandQueue& commands)
+{
+	// Bosses open fire once they are close to the screen, their pattern clock only runs from there on.
+	// At reduced detail dt spans several ticks, and the shots owed for all of them are fired in one batch
+	const BulletPatternData& pattern = Table[mType].bulletPattern;
+	if (pattern.emitters.empty() || mDetailLevel == MinimalDetail)
+		return;
+
+	sf::Time from = mPatternTime;
+	sf::Time to = mPatternTime + dt;
+	sf::Vector2f origin = getWorldPosition();
+	mPatternTime = to;
+
+	Command command;
+	command.category = Category::BulletSystem;
+	command.action = derivedAction<BulletNode>([&pattern, origin, from, to] (BulletNode& bullets, sf::Time)
+	{
+		bullets.firePattern(pattern, origin, from, to);
+	});
+
+	commands.push(command);
+}
+
+void Aircraft::createBullets(BulletNode& bullets) const
 {
 	Projectile::Type type = isAllied() ? Projectile::AlliedBullet : Projectile::EnemyBullet;
 
 	switch (mSpreadLevel)
 	{
 		case 1:
-			createProjectile(node, type, 0.0f, 0.5f, textures);
+			createBullet(bullets, type, 0.0f, 0.5f);
 			break;
 
 		case 2:
-			createProjectile(node, type, -0.33f, 0.33f, textures);
-			createProjectile(node, type, +0.33f, 0.33f, textures);
+			createBullet(bullets, type, -0.33f, 0.33f);
+			createBullet(bullets, type, +0.33f, 0.33f);
 			break;
 
 		case 3:
-			createProjectile(node, type, -0.5f, 0.33f, textures);
-			createProjectile(node, type,  0.0f, 0.5f, textures);
-			createProjectile(node, type, +0.5f, 0.33f, textures);
+			createBullet(bullets, type, -0.5f, 0.33f);
+			createBullet(bullets, type,  0.0f, 0.5f);
+			createBullet(bullets, type, +0.5f, 0.33f);
 			break;
 	}
 }
 
+void Aircraft::createBullet(BulletNode& bullets, Projectile::Type type, float xOffset, float yOffset) const
+{
+	sf::Vector2f offset(xOffset * mSprite.getGlobalBounds().width, yOffset * mSprite.getGlobalBounds().height);
+
+	float sign = isAllied() ? -1.f : +1.f;
+	bullets.addBullet(type, getWorldPosition() + offset * sign, sf::Vector2f(0.f, sign));
+}
+
 void Aircraft::createProjectile(SceneNode& node, Projectile::Type type, float xOffset, float yOffset, const TextureHolder& textures) const
 {
-	std::unique_ptr<Projectile> projectile(new Projectile(type, textures));
+	std::unique_ptr<Projectile> projectile(new Projectile(type, textures, mParticles));
 
 	sf::Vector2f offset(xOffset * mSprite.getGlobalBounds().width, yOffset * mSprite.getGlobalBounds().height);
 	sf::Vector2f velocity(0, projectile->getMaxSpeed());
@@ -348,21 +629,31 @@ void Aircraft::createPickup(SceneNode& node, const TextureHolder& textures) cons
 
 void Aircraft::updateTexts()
 {
-	// Display hitpoints
-	if (isDestroyed())
-		mHealthDisplay->setString("");
-	else
-		mHealthDisplay->setString(toString(getHitpoints()) + " HP");
+	// Formatting the strings is the costly part, so only do it when the values change
+	int hitpoints = isDestroyed() ? 0 : getHitpoints();
+	if (hitpoints != mDisplayedHitpoints)
+	{
+		// Display hitpoints
+		if (hitpoints == 0)
+			mHealthDisplay->setString("");
+		else
+			mHealthDisplay->setString(toString(hitpoints) + " HP");
+
+		mDisplayedHitpoints = hitpoints;
+	}
 	mHealthDisplay->setPosition(0.f, 50.f);
 	mHealthDisplay->setRotation(-getRotation());
 
 	// Display missiles, if available
-	if (mMissileDisplay)
+	int missiles = isDestroyed() ? 0 : mMissileAmmo;
+	if (mMissileDisplay && missiles != mDisplayedMissiles)
 	{
-		if (mMissileAmmo == 0 || isDestroyed())
+		if (missiles == 0)
 			mMissileDisplay->setString("");
 		else
-			mMissileDisplay->setString("M: " + toString(mMissileAmmo));
+			mMissileDisplay->setString("M: " + toString(missiles));
+
+		mDisplayedMissiles = missiles;
 	}
 }
 
@@ -384,6 +675,29 @@ void Aircraft::updateRollAnimation()
 	}
 }
 
+void Aircraft::updateSmoke()
+{
+	// Badly damaged aircraft trail smoke until they are repaired or destroyed
+	bool isDamaged = !isDestroyed() && getHitpoints() <= Table[mType].hitpoints / 3;
+	if (isDamaged && !mSmoke)
+	{
+		std::unique_ptr<EmitterNode> smoke(new EmitterNode(Particle::Smoke, *this, mTimers, mParticles));
+		mSmoke = smoke.get();
+		attachChild(std::move(smoke));
+	}
+	else if (!isDamaged)
+		stopSmoke();
+}
+
+void Aircraft::stopSmoke()
+{
+	if (!mSmoke)
+		return;
+
+	detachChild(*mSmoke);
+	mSmoke = nullptr;
+}
+
 Aircraft::Type Aircraft::getType() const
 {
 	return mType;
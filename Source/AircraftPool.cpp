@@ -0,0 +1,169 @@
+#include "AircraftPool.hpp"
+#include "Foreach.hpp"
+
+#include <SFML/System/Lock.hpp>
+
+
+AircraftPool::AircraftPool(const TextureHolder& textures, const FontHolder& fonts, TimerWheel& timers, BehaviorSystem& behaviors,
+	ParticleRegistry& particles)
+: mTextures(textures)
+, mFonts(fonts)
+, mTimers(timers)
+, mBehaviors(behaviors)
+, mParticles(particles)
+, mFree()
+, mReserved()
+, mPending()
+, mWorker(&AircraftPool::runWorker, this)
+, mMutex()
+, mJobs()
+, mBuilt()
+, mIsWorking(false)
+{
+	mReserved.fill(0);
+	mPending.fill(0);
+}
+
+AircraftPool::~AircraftPool()
+{
+	// Let the worker finish the aircraft it is building, but nothing after it
+	{
+		sf::Lock lock(mMutex);
+		mJobs.clear();
+	}
+
+	mWorker.wait();
+}
+
+void AircraftPool::reserve(Aircraft::Type type)
+{
+	collectBuilt();
+
+	// Only build what the spare aircraft and the ones under construction don't cover yet
+	++mReserved[type];
+	if (mFree[type].size() + mPending[type] >= mReserved[type])
+		return;
+
+	++mPending[type];
+
+	bool launch = false;
+	{
+		sf::Lock lock(mMutex);
+		mJobs.push_back(type);
+		if (!mIsWorking)
+		{
+			mIsWorking = true;
+			launch = true;
+		}
+	}
+
+	// An idle worker has already left its loop, launch() joins it before starting it again
+	if (launch)
+		mWorker.launch();
+}
+
+void AircraftPool::clearReservations()
+{
+	mReserved.fill(0);
+}
+
+void AircraftPool::prewarm()
+{
+	// Take the queued jobs back and build everything reserved right here, while the level is loading
+	{
+		sf::Lock lock(mMutex);
+		FOREACH(Aircraft::Type type, mJobs)
+			--mPending[type];
+		mJobs.clear();
+	}
+
+	for (std::size_t type = 0; type < Aircraft::TypeCount; ++type)
+	{
+		while (mFree[type].size() + mPending[type] < mReserved[type])
+		{
+			mFree[type].push_back(construct(static_cast<Aircraft::Type>(type)));
+			mFree[type].back()->createTexts(mFonts);
+		}
+	}
+}
+
+AircraftPool::AircraftPtr AircraftPool::acquire(Aircraft::Type type)
+{
+	collectBuilt();
+
+	if (mReserved[type] > 0)
+		--mReserved[type];
+
+	// Nothing spare: build it right away, like it was done without the pool
+	AircraftPtr aircraft;
+	if (mFree[type].empty())
+	{
+		aircraft = construct(type);
+		aircraft->createTexts(mFonts);
+	}
+	else
+	{
+		aircraft = std::move(mFree[type].back());
+		mFree[type].pop_back();
+	}
+
+	aircraft->spawn();
+	return aircraft;
+}
+
+void AircraftPool::release(AircraftPtr aircraft)
+{
+	aircraft->despawn();
+
+	Aircraft::Type type = aircraft->getType();
+	mFree[type].push_back(std::move(aircraft));
+}
+
+AircraftPool::AircraftPtr AircraftPool::construct(Aircraft::Type type) const
+{
+	return AircraftPtr(new Aircraft(type, mTextures, mTimers, mBehaviors, mParticles));
+}
+
+void AircraftPool::collectBuilt()
+{
+	AircraftList built;
+	{
+		sf::Lock lock(mMutex);
+		built.swap(mBuilt);
+	}
+
+	// The texts are the part of an aircraft that has to be created on the main thread
+	FOREACH(AircraftPtr& aircraft, built)
+	{
+		Aircraft::Type type = aircraft->getType();
+		aircraft->createTexts(mFonts);
+
+		--mPending[type];
+		mFree[type].push_back(std::move(aircraft));
+	}
+}
+
+void AircraftPool::runWorker()
+{
+	// Runs until the queue is empty, reserve() launches it again when new jobs arrive
+	while (true)
+	{
+		Aircraft::Type type;
+		{
+			sf::Lock lock(mMutex);
+			if (mJobs.empty())
+			{
+				mIsWorking = false;
+				return;
+			}
+
+			type = mJobs.front();
+			mJobs.pop_front();
+		}
+
+		AircraftPtr aircraft = construct(type);
+
+		sf::Lock lock(mMutex);
+		mBuilt.push_back(std::move(aircraft));
+	}
+}
@@ -0,0 +1,82 @@
+#include "AnimationClip.hpp"
+
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+
+AnimationClip::AnimationClip(const sf::Texture& texture, sf::Vector2i frameSize, std::size_t numFrames, sf::Time duration, bool repeat)
+: mTexture(&texture)
+, mFrameSize(frameSize)
+, mFrames()
+, mDuration(duration)
+, mTimePerFrame(duration / static_cast<float>(numFrames))
+, mRepeat(repeat)
+{
+	if (numFrames == 0 || mTimePerFrame <= sf::Time::Zero)
+		throw std::runtime_error("AnimationClip::AnimationClip - Clip needs at least one frame and a duration");
+
+	// Frames run left to right across the sheet, then continue on the next line
+	sf::Vector2i textureBounds(texture.getSize());
+	sf::IntRect textureRect(0, 0, frameSize.x, frameSize.y);
+
+	mFrames.reserve(numFrames);
+	for (std::size_t i = 0; i < numFrames; ++i)
+	{
+		mFrames.push_back(textureRect);
+
+		textureRect.left += textureRect.width;
+		if (textureRect.left + textureRect.width > textureBounds.x)
+		{
+			textureRect.left = 0;
+			textureRect.top += textureRect.height;
+		}
+	}
+}
+
+const sf::Texture& AnimationClip::getTexture() const
+{
+	return *mTexture;
+}
+
+sf::Vector2i AnimationClip::getFrameSize() const
+{
+	return mFrameSize;
+}
+
+std::size_t AnimationClip::getNumFrames() const
+{
+	return mFrames.size();
+}
+
+sf::Time AnimationClip::getDuration() const
+{
+	return mDuration;
+}
+
+bool AnimationClip::isRepeating() const
+{
+	return mRepeat;
+}
+
+std::size_t AnimationClip::getFrameIndex(sf::Time elapsedTime) const
+{
+	std::size_t frame = static_cast<std::size_t>(std::max(elapsedTime.asMicroseconds(), sf::Int64(0)) / mTimePerFrame.asMicroseconds());
+
+	// Repeating clips start over, the others hold their last frame
+	if (mRepeat)
+		return frame % mFrames.size();
+	else
+		return std::min(frame, mFrames.size() - 1);
+}
+
+const sf::IntRect& AnimationClip::getFrame(sf::Time elapsedTime) const
+{
+	return mFrames[getFrameIndex(elapsedTime)];
+}
+
+bool AnimationClip::isFinished(sf::Time elapsedTime) const
+{
+	return !mRepeat && elapsedTime >= mDuration;
+}
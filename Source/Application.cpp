@@ -8,24 +8,91 @@
 #include "PauseState.hpp"
 #include "SettingsState.hpp"
 #include "GameOverState.hpp"
+#include "NetplayState.hpp"
+#include "SpectatorState.hpp"
+#include "CoopState.hpp"
+#include "EndlessState.hpp"
+#include "World.hpp"
+#include "BulletNode.hpp"
+
+#include <SFML/Audio/Listener.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+
+namespace
+{
+	// Simulated time between two lines of the soak test report
+	const sf::Time ReportInterval = sf::seconds(60.f);
+
+	bool hasOption(int argc, char* argv[], const char* option)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], option) == 0)
+				return true;
+		}
+
+		return false;
+	}
+
+	int getOptionValue(int argc, char* argv[], const char* option, int defaultValue)
+	{
+		for (int i = 1; i + 1 < argc; ++i)
+		{
+			if (std::strcmp(argv[i], option) == 0)
+				return std::atoi(argv[i + 1]);
+		}
+
+		return defaultValue;
+	}
+
+	// --autopilot lets the computer play, --headless does the same without rendering and as fast as possible
+	std::unique_ptr<Autopilot> createAutopilot(int argc, char* argv[])
+	{
+		if (!hasOption(argc, argv, "--autopilot") && !hasOption(argc, argv, "--headless"))
+			return nullptr;
+
+		int runs = getOptionValue(argc, argv, "--runs", 1);
+		return std::unique_ptr<Autopilot>(new Autopilot(runs > 0 ? static_cast<std::size_t>(runs) : 1));
+	}
+}
 
 
 const sf::Time Application::TimePerFrame = sf::seconds(1.f / 60.f);
 
-Application::Application()
+Application::Application(int argc, char* argv[])
 	: mWindow(sf::VideoMode(1024, 768), "ARCADE JET 2000 v1.0", sf::Style::Close)
 	, mTextures()
 	, mFonts()
 	, mPlayer()
 	, mMusic()
 	, mSounds()
-	, mStateStack(State::Context(mWindow, mTextures, mFonts, mPlayer, mMusic, mSounds))
+	, mAutopilot(createAutopilot(argc, argv))
+	, mHeadless(hasOption(argc, argv, "--headless"))
+	, mStateStack(State::Context(mWindow, mTextures, mFonts, mPlayer, mMusic, mSounds, mAutopilot.get()))
 	, mStatisticsText()
 	, mStatisticsUpdateTime()
 	, mStatisticsNumFrames(0)
+	, mReportSimulatedTime(sf::Time::Zero)
+	, mReportTickTime(sf::Time::Zero)
+	, mReportMaxTickTime(sf::Time::Zero)
+	, mReportNumTicks(0)
+	, mTotalSimulatedTime(sf::Time::Zero)
 {
 	mWindow.setKeyRepeatEnabled(false);
-	mWindow.setVerticalSyncEnabled(true);
+	mWindow.setVerticalSyncEnabled(!mHeadless);
+
+	// Textures and render textures still need the window's GL context, so headless only hides it.
+	// Sounds keep playing at zero volume, leaks in the sound list must stay visible in the report.
+	if (mHeadless)
+	{
+		mWindow.setVisible(false);
+		sf::Listener::setGlobalVolume(0.f);
+	}
 
 	mFonts.load(Fonts::Main, "Media/sansation.ttf");
 	mFonts.load(Fonts::Arcade, "Media/emulogic.ttf");
@@ -39,13 +106,19 @@ Application::Application()
 	mStatisticsText.setCharacterSize(10u);
 
 	registerStates();
-	mStateStack.pushState(States::Title);
+	mStateStack.pushState(mAutopilot ? States::Menu : States::Title);
 
-	mMusic.setVolume(25.f);
+	mMusic.setVolume(mHeadless ? 0.f : 25.f);
 }
 
 void Application::run()
 {
+	if (mHeadless)
+	{
+		runHeadless();
+		return;
+	}
+
 	sf::Clock clock;
 	sf::Time timeSinceLastUpdate = sf::Time::Zero;
 
@@ -58,7 +131,10 @@ void Application::run()
 			timeSinceLastUpdate -= TimePerFrame;
 
 			processInput();
+
+			sf::Clock tickClock;
 			update(TimePerFrame);
+			updateSoakReport(tickClock.getElapsedTime());
 
 			// Check inside this loop, because stack might be empty before update() call
 			if (mStateStack.isEmpty())
@@ -70,6 +146,22 @@ void Application::run()
 	}
 }
 
+void Application::runHeadless()
+{
+	// Same fixed time step, but ticks follow each other without waiting for real time or drawing
+	while (mWindow.isOpen())
+	{
+		processInput();
+
+		sf::Clock tickClock;
+		update(TimePerFrame);
+		updateSoakReport(tickClock.getElapsedTime());
+
+		if (mStateStack.isEmpty())
+			mWindow.close();
+	}
+}
+
 void Application::processInput()
 {
 	sf::Event event;
@@ -113,6 +205,45 @@ void Application::updateStatistics(sf::Time dt)
 	}
 }
 
+void Application::updateSoakReport(sf::Time tickTime)
+{
+	if (!mAutopilot)
+		return;
+
+	mReportSimulatedTime += TimePerFrame;
+	mTotalSimulatedTime += TimePerFrame;
+	mReportTickTime += tickTime;
+	mReportMaxTickTime = std::max(mReportMaxTickTime, tickTime);
+	mReportNumTicks += 1;
+
+	if (mReportSimulatedTime >= ReportInterval)
+	{
+		// Steadily growing sound or particle counts point to a leak
+		sf::Time bulletUpdateTime = mAutopilot->takeMaxBulletUpdateTime();
+		Autopilot::DetailCounts detailCounts = mAutopilot->takeDetailCounts();
+		std::cout << "[" << static_cast<int>(mTotalSimulatedTime.asSeconds()) << " s]"
+			<< " ticks/s: " << static_cast<int>(mReportNumTicks / std::max(mReportTickTime, sf::microseconds(1)).asSeconds())
+			<< ", tick avg: " << mReportTickTime.asMicroseconds() / static_cast<sf::Int64>(mReportNumTicks) << " us"
+			<< ", tick max: " << mReportMaxTickTime.asMicroseconds() << " us"
+			<< ", sounds: " << mSounds.getSoundCount()
+			<< ", particles: " << mAutopilot->getParticleCount()
+			<< ", bullets: " << mAutopilot->getBulletCount()
+			<< ", bullet update max: " << bulletUpdateTime.asMicroseconds() << " us"
+			<< (bulletUpdateTime > BulletNode::UpdateBudget ? " (over budget)" : "")
+			<< ", entities: " << mAutopilot->getEntityCount()
+			<< ", enemy detail full/reduced/minimal: " << detailCounts[Aircraft::FullDetail]
+			<< "/" << detailCounts[Aircraft::ReducedDetail] << "/" << detailCounts[Aircraft::MinimalDetail]
+			<< ", run: " << mAutopilot->getStartedRuns()
+			<< ", level: " << World::getLevel() - 1
+			<< std::endl;
+
+		mReportSimulatedTime = sf::Time::Zero;
+		mReportTickTime = sf::Time::Zero;
+		mReportMaxTickTime = sf::Time::Zero;
+		mReportNumTicks = 0;
+	}
+}
+
 void Application::registerStates()
 {
 	mStateStack.registerState<TitleState>(States::Title);
@@ -121,4 +252,8 @@ void Application::registerStates()
 	mStateStack.registerState<PauseState>(States::Pause);
 	mStateStack.registerState<SettingsState>(States::Settings);
 	mStateStack.registerState<GameOverState>(States::GameOver);
+	mStateStack.registerState<NetplayState>(States::Netplay);
+	mStateStack.registerState<SpectatorState>(States::Spectator);
+	mStateStack.registerState<CoopState>(States::Coop);
+	mStateStack.registerState<EndlessState>(States::Endless);
 }
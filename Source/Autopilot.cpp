@@ -0,0 +1,297 @@
+#include "Autopilot.hpp"
+#include "World.hpp"
+#include "Aircraft.hpp"
+#include "Projectile.hpp"
+#include "ParticleNode.hpp"
+#include "BulletNode.hpp"
+#include "SwarmNode.hpp"
+#include "CommandQueue.hpp"
+#include "Foreach.hpp"
+#include "Utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace
+{
+	// Points in time ahead at which a move is checked for collisions
+	const float LookAhead[] = { 0.1f, 0.2f, 0.35f };
+	const std::size_t LookAheadCount = sizeof(LookAhead) / sizeof(LookAhead[0]);
+
+	// Distance the aircraft keeps from bullets and enemies, on top of their size
+	const float ProjectileRadius = 45.f;
+	const float AircraftRadius = 80.f;
+
+	// Same as World::adaptPlayerPosition()
+	const float BorderDistance = 40.f;
+
+	// The pilot waits in the lower part of the screen, enemies come from above
+	const float HomeHeight = 0.75f;
+
+	const sf::Time MissileInterval = sf::seconds(3.f);
+	const std::size_t MissileEnemyCount = 3;
+}
+
+Autopilot::Autopilot(std::size_t runs)
+: mPilot(1)
+, mThreats()
+, mPickups()
+, mViewBounds()
+, mLastViewTop(0.f)
+, mScrollVelocity()
+, mMissileCooldown(sf::Time::Zero)
+, mRuns(runs)
+, mStartedRuns(0)
+, mEntityCount(0)
+, mParticleCount(0)
+, mBulletCount(0)
+, mMaxBulletUpdateTime(sf::Time::Zero)
+, mDetailCounts()
+{
+}
+
+void Autopilot::handleRealtimeInput(const World& world, CommandQueue& commands)
+{
+	mViewBounds = world.getViewBounds();
+
+	// Like missile guidance: collect the surroundings first, then steer in a command executed after them
+	Command collector;
+	collector.category = Category::EnemyAircraft | Category::EnemyProjectile | Category::Pickup;
+	collector.action = derivedAction<Entity>([this] (Entity& entity, sf::Time)
+	{
+		if (entity.isDestroyed())
+			return;
+
+		if (entity.getCategory() & Category::Pickup)
+		{
+			mPickups.push_back(entity.getWorldPosition());
+			return;
+		}
+
+		Threat threat;
+		threat.position = entity.getWorldPosition();
+		threat.velocity = entity.getVelocity();
+		threat.radius = (entity.getCategory() & Category::EnemyAircraft) ? AircraftRadius : ProjectileRadius;
+		mThreats.push_back(threat);
+	});
+
+	// Only the enemy bullets on screen can be in the way
+	Command bulletCollector;
+	bulletCollector.category = Category::BulletSystem;
+	bulletCollector.action = derivedAction<BulletNode>([this] (BulletNode& bullets, sf::Time)
+	{
+		for (std::size_t i = 0; i < bullets.getBulletCount(BulletNode::Enemy); ++i)
+		{
+			Threat threat;
+			threat.position = bullets.getBulletPosition(BulletNode::Enemy, i);
+			if (!mViewBounds.contains(threat.position))
+				continue;
+
+			threat.velocity = bullets.getBulletVelocity(BulletNode::Enemy, i);
+			threat.radius = ProjectileRadius;
+			mThreats.push_back(threat);
+		}
+	});
+
+	Command swarmCollector;
+	swarmCollector.category = Category::Swarm;
+	swarmCollector.action = derivedAction<SwarmNode>([this] (SwarmNode& swarm, sf::Time)
+	{
+		for (std::size_t i = 0; i < swarm.getDroneCount(); ++i)
+		{
+			Threat threat;
+			threat.position = swarm.getDronePosition(i);
+			if (!mViewBounds.contains(threat.position))
+				continue;
+
+			threat.velocity = swarm.getDroneVelocity(i);
+			threat.radius = ProjectileRadius;
+			mThreats.push_back(threat);
+		}
+	});
+
+	Command counter;
+	counter.category = Category::Aircraft | Category::Projectile | Category::Pickup | Category::ParticleSystem | Category::BulletSystem;
+	counter.action = [this] (SceneNode& node, sf::Time)
+	{
+		if (node.getCategory() & Category::BulletSystem)
+		{
+			BulletNode& bullets = static_cast<BulletNode&>(node);
+			mBulletCount = bullets.getBulletCount();
+			mMaxBulletUpdateTime = std::max(mMaxBulletUpdateTime, bullets.getUpdateTime());
+		}
+		else if (node.getCategory() & Category::ParticleSystem)
+			mParticleCount += static_cast<ParticleNode&>(node).getParticleCount();
+		else
+			++mEntityCount;
+
+		if (node.getCategory() & Category::EnemyAircraft)
+			++mDetailCounts[static_cast<Aircraft&>(node).getDetailLevel()];
+	};
+
+	Command pilot;
+	pilot.category = Category::PlayerAircraft;
+	pilot.action = derivedAction<Aircraft>([this, &commands] (Aircraft& aircraft, sf::Time dt)
+	{
+		if (aircraft.getIdentifier() != 1 || aircraft.isDestroyed())
+			return;
+
+		// The queue is still being processed, the action commands run within the same update
+		mPilot.applyActions(steer(aircraft, dt), commands);
+
+		mThreats.clear();
+		mPickups.clear();
+	});
+
+	mEntityCount = 0;
+	mParticleCount = 0;
+
+	commands.push(collector);
+	commands.push(bulletCollector);
+	commands.push(swarmCollector);
+	commands.push(counter);
+	commands.push(pilot);
+}
+
+bool Autopilot::startRun()
+{
+	if (mStartedRuns >= mRuns)
+		return false;
+
+	++mStartedRuns;
+	return true;
+}
+
+std::size_t Autopilot::getStartedRuns() const
+{
+	return mStartedRuns;
+}
+
+std::size_t Autopilot::getEntityCount() const
+{
+	return mEntityCount;
+}
+
+std::size_t Autopilot::getParticleCount() const
+{
+	return mParticleCount;
+}
+
+std::size_t Autopilot::getBulletCount() const
+{
+	return mBulletCount;
+}
+
+sf::Time Autopilot::takeMaxBulletUpdateTime()
+{
+	sf::Time time = mMaxBulletUpdateTime;
+	mMaxBulletUpdateTime = sf::Time::Zero;
+	return time;
+}
+
+Autopilot::DetailCounts Autopilot::takeDetailCounts()
+{
+	DetailCounts counts = mDetailCounts;
+	mDetailCounts.fill(0);
+	return counts;
+}
+
+Player::ActionSet Autopilot::steer(const Aircraft& aircraft, sf::Time dt)
+{
+	// Threats are compared in view coordinates, so the scrolling has to be taken out of their velocity
+	if (dt > sf::Time::Zero)
+		mScrollVelocity.y = (mViewBounds.top - mLastViewTop) / dt.asSeconds();
+	mLastViewTop = mViewBounds.top;
+
+	// Try all eight directions and standing still, take the safest
+	Player::ActionSet bestActions = 0;
+	float bestRating = std::numeric_limits<float>::max();
+
+	for (int y = -1; y <= 1; ++y)
+	{
+		for (int x = -1; x <= 1; ++x)
+		{
+			sf::Vector2f direction(static_cast<float>(x), static_cast<float>(y));
+			if (x != 0 || y != 0)
+				direction = unitVector(direction);
+
+			float rating = rateMove(direction, aircraft);
+			if (rating >= bestRating)
+				continue;
+
+			bestRating = rating;
+			bestActions = 0;
+			if (x < 0) bestActions |= 1 << Player::MoveLeft;
+			if (x > 0) bestActions |= 1 << Player::MoveRight;
+			if (y < 0) bestActions |= 1 << Player::MoveUp;
+			if (y > 0) bestActions |= 1 << Player::MoveDown;
+		}
+	}
+
+	bestActions |= 1 << Player::Fire;
+
+	// Missiles are saved for crowded moments
+	mMissileCooldown -= dt;
+	std::size_t enemyCount = 0;
+	FOREACH(const Threat& threat, mThreats)
+	{
+		if (threat.radius == AircraftRadius && mViewBounds.contains(threat.position))
+			++enemyCount;
+	}
+
+	if (enemyCount >= MissileEnemyCount && mMissileCooldown <= sf::Time::Zero)
+	{
+		bestActions |= 1 << Player::LaunchMissile;
+		mMissileCooldown = MissileInterval;
+	}
+
+	return bestActions;
+}
+
+float Autopilot::rateMove(sf::Vector2f direction, const Aircraft& aircraft) const
+{
+	sf::Vector2f start = aircraft.getWorldPosition();
+	float speed = aircraft.getMaxSpeed();
+	float rating = 0.f;
+
+	sf::FloatRect reachable(mViewBounds.left + BorderDistance, mViewBounds.top + BorderDistance,
+		mViewBounds.width - 2.f * BorderDistance, mViewBounds.height - 2.f * BorderDistance);
+
+	sf::Vector2f position = start;
+	for (std::size_t i = 0; i < LookAheadCount; ++i)
+	{
+		float time = LookAhead[i];
+
+		// Moves into the border are cut short, just like in World
+		position = start + direction * speed * time;
+		position.x = std::max(reachable.left, std::min(position.x, reachable.left + reachable.width));
+		position.y = std::max(reachable.top, std::min(position.y, reachable.top + reachable.height));
+
+		FOREACH(const Threat& threat, mThreats)
+		{
+			sf::Vector2f threatPosition = threat.position + (threat.velocity - mScrollVelocity) * time;
+			float gap = threat.radius - length(position - threatPosition);
+
+			// Earlier collisions are more certain, weigh them higher
+			if (gap > 0.f)
+				rating += gap * gap / time;
+		}
+	}
+
+	// Head for the closest pickup
+	float pickupDistance = std::numeric_limits<float>::max();
+	FOREACH(sf::Vector2f pickup, mPickups)
+		pickupDistance = std::min(pickupDistance, length(pickup - position));
+
+	if (!mPickups.empty())
+		rating += pickupDistance;
+	else
+		rating += std::abs(position.y - (mViewBounds.top + HomeHeight * mViewBounds.height));
+
+	// Stay away from the sides, where there is no room to dodge
+	rating += 0.5f * std::abs(position.x - (mViewBounds.left + mViewBounds.width / 2.f));
+
+	return rating;
+}
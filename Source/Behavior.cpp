@@ -0,0 +1,84 @@
+#include "Behavior.hpp"
+#include "DataTables.hpp"
+#include "Utility.hpp"
+#include "Foreach.hpp"
+
+#include <cmath>
+
+
+BehaviorStep::BehaviorStep()
+: op(Wait)
+, direction()
+, distance(0.f)
+, duration(sf::Time::Zero)
+, count(0)
+{
+}
+
+namespace Behavior
+{
+	BehaviorStep move(float angle, float distance)
+	{
+		float radians = toRadian(angle + 90.f);
+
+		BehaviorStep step;
+		step.op = BehaviorStep::Move;
+		step.direction = sf::Vector2f(std::cos(radians), std::sin(radians));
+		step.distance = distance;
+		return step;
+	}
+
+	BehaviorStep moveBy(sf::Vector2f offset)
+	{
+		BehaviorStep step;
+		step.op = BehaviorStep::Move;
+		step.distance = length(offset);
+		step.direction = (step.distance > 0.f) ? offset / step.distance : sf::Vector2f();
+		return step;
+	}
+
+	BehaviorStep wait(sf::Time duration)
+	{
+		BehaviorStep step;
+		step.op = BehaviorStep::Wait;
+		step.duration = duration;
+		return step;
+	}
+
+	BehaviorStep fireBurst(int count, sf::Time interval)
+	{
+		BehaviorStep step;
+		step.op = BehaviorStep::FireBurst;
+		step.count = count;
+		step.duration = interval;
+		return step;
+	}
+
+	BehaviorStep waitUntilPlayerNear(float radius)
+	{
+		BehaviorStep step;
+		step.op = BehaviorStep::WaitUntilPlayerNear;
+		step.distance = radius;
+		return step;
+	}
+
+	BehaviorScript fromDirections(const std::vector<Direction>& directions)
+	{
+		BehaviorScript script;
+		FOREACH(const Direction& direction, directions)
+			script.push_back(move(direction.angle, direction.distance));
+
+		return script;
+	}
+
+	bool hasFireBursts(const BehaviorScript& script)
+	{
+		FOREACH(const BehaviorStep& step, script)
+		{
+			if (step.op == BehaviorStep::FireBurst)
+				return true;
+		}
+
+		return false;
+	}
+}
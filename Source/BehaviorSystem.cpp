@@ -0,0 +1,171 @@
+#include "BehaviorSystem.hpp"
+#include "Aircraft.hpp"
+#include "Foreach.hpp"
+
+#include <cassert>
+
+
+namespace
+{
+	// Waiting for a player is the only step that has to look, a few times per second is enough
+	const TimerWheel::Tick PlayerPollTicks = 6;
+}
+
+const BehaviorSystem::Frame BehaviorSystem::NoFrame = static_cast<Frame>(-1);
+
+BehaviorSystem::BehaviorSystem(TimerWheel& timers, const std::vector<Aircraft*>& players)
+: mTimers(timers)
+, mPlayers(players)
+, mFrames()
+, mFreeFrames()
+{
+}
+
+BehaviorSystem::Frame BehaviorSystem::start(Aircraft& aircraft, const BehaviorScript& script, std::size_t step, TimerWheel::Tick delay, int burstShots)
+{
+	if (script.empty())
+		return NoFrame;
+
+	Frame frame;
+	if (!mFreeFrames.empty())
+	{
+		frame = mFreeFrames.back();
+		mFreeFrames.pop_back();
+	}
+	else
+	{
+		frame = mFrames.size();
+		mFrames.push_back(ScriptFrame());
+	}
+
+	ScriptFrame& current = mFrames[frame];
+	current.aircraft = &aircraft;
+	current.script = &script;
+	current.step = step % script.size();
+	current.burstShots = burstShots;
+	current.timer = TimerWheel::InvalidID;
+
+	if (delay == 0)
+		resume(frame);
+	else
+		suspend(frame, delay);
+
+	return frame;
+}
+
+void BehaviorSystem::stop(Frame frame)
+{
+	if (frame == NoFrame)
+		return;
+
+	assert(mFrames[frame].aircraft != nullptr);
+
+	mTimers.cancel(mFrames[frame].timer);
+	mFrames[frame].aircraft = nullptr;
+	mFreeFrames.push_back(frame);
+}
+
+std::size_t BehaviorSystem::getStep(Frame frame) const
+{
+	return mFrames[frame].step;
+}
+
+TimerWheel::Tick BehaviorSystem::getRemainingTicks(Frame frame) const
+{
+	return mTimers.getRemainingTicks(mFrames[frame].timer);
+}
+
+int BehaviorSystem::getBurstShots(Frame frame) const
+{
+	return mFrames[frame].burstShots;
+}
+
+std::size_t BehaviorSystem::getRunningCount() const
+{
+	return mFrames.size() - mFreeFrames.size();
+}
+
+void BehaviorSystem::resume(Frame frame)
+{
+	ScriptFrame& current = mFrames[frame];
+	Aircraft& aircraft = *current.aircraft;
+	const BehaviorScript& script = *current.script;
+
+	// Run steps until one of them suspends the script. Steps that finish right away
+	// are limited to one pass, so a script of nothing but those can't hang the tick
+	for (std::size_t executed = 0; executed < script.size(); ++executed)
+	{
+		const BehaviorStep& step = script[current.step];
+		switch (step.op)
+		{
+			case BehaviorStep::Move:
+			{
+				float speed = aircraft.getMaxSpeed();
+				aircraft.setVelocity(step.direction * speed);
+				advance(current);
+				suspend(frame, TimerWheel::toTicks(sf::seconds(speed > 0.f ? step.distance / speed : 0.f)));
+				return;
+			}
+
+			case BehaviorStep::Wait:
+				aircraft.setVelocity(0.f, 0.f);
+				advance(current);
+				suspend(frame, TimerWheel::toTicks(step.duration));
+				return;
+
+			case BehaviorStep::FireBurst:
+				if (current.burstShots == 0)
+					current.burstShots = step.count;
+
+				aircraft.fireBurstShot();
+				if (--current.burstShots <= 0)
+				{
+					current.burstShots = 0;
+					advance(current);
+				}
+				suspend(frame, TimerWheel::toTicks(step.duration));
+				return;
+
+			case BehaviorStep::WaitUntilPlayerNear:
+				if (!isPlayerNear(aircraft, step.distance))
+				{
+					suspend(frame, PlayerPollTicks);
+					return;
+				}
+				advance(current);
+				break;
+		}
+	}
+
+	suspend(frame, 1);
+}
+
+void BehaviorSystem::suspend(Frame frame, TimerWheel::Tick ticks)
+{
+	mFrames[frame].timer = mTimers.scheduleAt(mTimers.getCurrentTick() + ticks, [this, frame] ()
+	{
+		resume(frame);
+	});
+}
+
+void BehaviorSystem::advance(ScriptFrame& frame)
+{
+	frame.step = (frame.step + 1) % frame.script->size();
+}
+
+bool BehaviorSystem::isPlayerNear(const Aircraft& aircraft, float radius) const
+{
+	sf::Vector2f position = aircraft.getWorldPosition();
+
+	FOREACH(const Aircraft* player, mPlayers)
+	{
+		if (player->isDestroyed())
+			continue;
+
+		sf::Vector2f offset = player->getWorldPosition() - position;
+		if (offset.x * offset.x + offset.y * offset.y <= radius * radius)
+			return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,377 @@
+#include "BulletNode.hpp"
+#include "Aircraft.hpp"
+#include "DataTables.hpp"
+#include "Snapshot.hpp"
+#include "ResourceHolder.hpp"
+#include "Foreach.hpp"
+#include "Utility.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define BULLETNODE_SSE2
+	#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	const std::vector<ProjectileData> Table = initializeProjectileData();
+
+	// Moves count bullets by their direction times speed times seconds. The vector and the scalar
+	// path do the same single precision operations in the same order, so peers using either agree
+	void integrate(float* positionX, float* positionY, const float* directionX, const float* directionY,
+		const float* speed, std::size_t count, float seconds)
+	{
+		std::size_t i = 0;
+
+#ifdef BULLETNODE_SSE2
+		__m128 time = _mm_set1_ps(seconds);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 step = _mm_mul_ps(_mm_loadu_ps(speed + i), time);
+			_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(_mm_loadu_ps(directionX + i), step)));
+			_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(_mm_loadu_ps(directionY + i), step)));
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			float step = speed[i] * seconds;
+			positionX[i] += directionX[i] * step;
+			positionY[i] += directionY[i] * step;
+		}
+	}
+}
+
+const sf::Time BulletNode::UpdateBudget = sf::microseconds(500);
+const sf::Uint32 BulletNode::FirstBulletId = 0x80000000u;
+
+BulletNode::BulletNode(const TextureHolder& textures, const std::vector<Aircraft*>& players)
+: SceneNode()
+, mTexture(textures.get(Table[Projectile::EnemyBullet].texture))
+, mPlayers(players)
+, mBullets()
+, mNextBulletId(FirstBulletId)
+, mUpdateTime(sf::Time::Zero)
+, mVertexArray(sf::Quads)
+, mNeedsVertexUpdate(true)
+{
+}
+
+void BulletNode::addBullet(Projectile::Type type, sf::Vector2f position, sf::Vector2f direction)
+{
+	addBullet(type, position, direction, Table[type].speed, mNextBulletId++);
+}
+
+void BulletNode::firePattern(const BulletPatternData& pattern, sf::Vector2f origin, sf::Time from, sf::Time to)
+{
+	// Integer microseconds, so that every peer fires exactly the same shots
+	sf::Int64 begin = from.asMicroseconds();
+	sf::Int64 end = to.asMicroseconds();
+	sf::Int64 cycle = pattern.cycle.asMicroseconds();
+
+	// Aimed emitters all look at the same player, find it once
+	float aimAngle = 0.f;
+	bool hasAimAngle = false;
+
+	FOREACH(const BulletEmitter& emitter, pattern.emitters)
+	{
+		sf::Int64 interval = emitter.interval.asMicroseconds();
+		if (interval <= 0)
+			continue;
+
+		if (emitter.aimed && !hasAimAngle)
+		{
+			sf::Vector2f target = getAimTarget(origin) - origin;
+			aimAngle = toDegree(std::atan2(target.y, target.x)) - 90.f;
+			hasAimAngle = true;
+		}
+
+		// Shots fall on whole multiples of the interval, the ones at 'from' were fired last time
+		for (sf::Int64 shot = begin / interval + 1; shot * interval <= end; ++shot)
+		{
+			sf::Int64 time = shot * interval;
+			sf::Int64 phase = (cycle > 0) ? time % cycle : time;
+			if (phase < emitter.begin.asMicroseconds() || phase >= emitter.end.asMicroseconds())
+				continue;
+
+			float angle = emitter.angle + emitter.spin * static_cast<float>(time) / 1000000.f;
+			if (emitter.aimed)
+				angle += aimAngle;
+
+			// Streams are spread symmetrically around the emitter's angle, 0 degrees points down the screen
+			for (int stream = 0; stream < emitter.streams; ++stream)
+			{
+				float radians = toRadian(angle + emitter.spread * (stream - (emitter.streams - 1) / 2.f) + 90.f);
+				sf::Vector2f direction(std::cos(radians), std::sin(radians));
+
+				// A shot due earlier in the step has already flown for the rest of it, batched shots don't bunch up
+				float flightTime = static_cast<float>(end - time) / 1000000.f;
+				sf::Vector2f position = origin + direction * emitter.speed * flightTime;
+
+				addBullet(Projectile::PatternBullet, position, direction, emitter.speed, mNextBulletId++);
+			}
+		}
+	}
+}
+
+void BulletNode::removeOutside(const sf::FloatRect& bounds)
+{
+	FOREACH(Bullets& bullets, mBullets)
+	{
+		for (std::size_t i = 0; i < bullets.positionX.size(); )
+		{
+			if (!bounds.contains(bullets.positionX[i], bullets.positionY[i]))
+				removeBullet(bullets, i);
+			else
+				++i;
+		}
+	}
+}
+
+int BulletNode::removeHits(Side side, const sf::FloatRect& bounds)
+{
+	Bullets& bullets = mBullets[side];
+
+	int damage = 0;
+	for (std::size_t i = 0; i < bullets.positionX.size(); )
+	{
+		// Gun bullets hit with their whole sprite, pattern bullets only with their center,
+		// dodging through a pattern has to be possible
+		const ProjectileData& data = Table[bullets.type[i]];
+		float marginX = (bullets.type[i] == Projectile::PatternBullet) ? 0.f : data.textureRect.width / 2.f;
+		float marginY = (bullets.type[i] == Projectile::PatternBullet) ? 0.f : data.textureRect.height / 2.f;
+
+		if (bullets.positionX[i] >= bounds.left - marginX && bullets.positionX[i] <= bounds.left + bounds.width + marginX
+			&& bullets.positionY[i] >= bounds.top - marginY && bullets.positionY[i] <= bounds.top + bounds.height + marginY)
+		{
+			damage += data.damage;
+			removeBullet(bullets, i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	return damage;
+}
+
+std::size_t BulletNode::getBulletCount() const
+{
+	return mBullets[Allied].positionX.size() + mBullets[Enemy].positionX.size();
+}
+
+std::size_t BulletNode::getBulletCount(Side side) const
+{
+	return mBullets[side].positionX.size();
+}
+
+sf::Vector2f BulletNode::getBulletPosition(Side side, std::size_t index) const
+{
+	const Bullets& bullets = mBullets[side];
+	return sf::Vector2f(bullets.positionX[index], bullets.positionY[index]);
+}
+
+sf::Vector2f BulletNode::getBulletVelocity(Side side, std::size_t index) const
+{
+	const Bullets& bullets = mBullets[side];
+	return sf::Vector2f(bullets.directionX[index], bullets.directionY[index]) * bullets.speed[index];
+}
+
+sf::Time BulletNode::getUpdateTime() const
+{
+	return mUpdateTime;
+}
+
+void BulletNode::saveState(std::vector<BulletState>& states, sf::Uint32& nextBulletId) const
+{
+	states.clear();
+	FOREACH(const Bullets& bullets, mBullets)
+	{
+		for (std::size_t i = 0; i < bullets.positionX.size(); ++i)
+		{
+			BulletState state;
+			state.id = bullets.id[i];
+			state.type = bullets.type[i];
+			state.position = sf::Vector2f(bullets.positionX[i], bullets.positionY[i]);
+			state.direction = sf::Vector2f(bullets.directionX[i], bullets.directionY[i]);
+			state.speed = bullets.speed[i];
+			states.push_back(state);
+		}
+	}
+
+	nextBulletId = mNextBulletId;
+}
+
+void BulletNode::loadState(const std::vector<BulletState>& states, sf::Uint32 nextBulletId)
+{
+	FOREACH(Bullets& bullets, mBullets)
+	{
+		bullets.positionX.clear();
+		bullets.positionY.clear();
+		bullets.directionX.clear();
+		bullets.directionY.clear();
+		bullets.speed.clear();
+		bullets.type.clear();
+		bullets.id.clear();
+	}
+
+	// Saved side by side in array order, so the arrays come back exactly as they were
+	FOREACH(const BulletState& state, states)
+		addBullet(static_cast<Projectile::Type>(state.type), state.position, state.direction, state.speed, state.id);
+
+	mNextBulletId = nextBulletId;
+	mNeedsVertexUpdate = true;
+}
+
+unsigned int BulletNode::getCategory() const
+{
+	return Category::BulletSystem;
+}
+
+void BulletNode::translateOrigin(sf::Vector2f offset)
+{
+	FOREACH(Bullets& bullets, mBullets)
+	{
+		for (std::size_t i = 0; i < bullets.positionX.size(); ++i)
+		{
+			bullets.positionX[i] += offset.x;
+			bullets.positionY[i] += offset.y;
+		}
+	}
+
+	mNeedsVertexUpdate = true;
+}
+
+void BulletNode::updateCurrent(sf::Time dt, CommandQueue&)
+{
+	sf::Clock clock;
+
+	FOREACH(Bullets& bullets, mBullets)
+	{
+		if (bullets.positionX.empty())
+			continue;
+
+		integrate(&bullets.positionX[0], &bullets.positionY[0], &bullets.directionX[0], &bullets.directionY[0],
+			&bullets.speed[0], bullets.positionX.size(), dt.asSeconds());
+	}
+
+	mNeedsVertexUpdate = true;
+	mUpdateTime = clock.getElapsedTime();
+}
+
+void BulletNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if (getBulletCount() == 0)
+		return;
+
+	if (mNeedsVertexUpdate)
+	{
+		computeVertices();
+		mNeedsVertexUpdate = false;
+	}
+
+	states.texture = &mTexture;
+	target.draw(mVertexArray, states);
+}
+
+void BulletNode::addBullet(Projectile::Type type, sf::Vector2f position, sf::Vector2f direction, float speed, sf::Uint32 id)
+{
+	Bullets& bullets = mBullets[getSide(type)];
+
+	bullets.positionX.push_back(position.x);
+	bullets.positionY.push_back(position.y);
+	bullets.directionX.push_back(direction.x);
+	bullets.directionY.push_back(direction.y);
+	bullets.speed.push_back(speed);
+	bullets.type.push_back(static_cast<sf::Uint8>(type));
+	bullets.id.push_back(id);
+}
+
+void BulletNode::removeBullet(Bullets& bullets, std::size_t index)
+{
+	// Order doesn't matter, move the last bullet into the gap
+	bullets.positionX[index] = bullets.positionX.back();
+	bullets.positionY[index] = bullets.positionY.back();
+	bullets.directionX[index] = bullets.directionX.back();
+	bullets.directionY[index] = bullets.directionY.back();
+	bullets.speed[index] = bullets.speed.back();
+	bullets.type[index] = bullets.type.back();
+	bullets.id[index] = bullets.id.back();
+
+	bullets.positionX.pop_back();
+	bullets.positionY.pop_back();
+	bullets.directionX.pop_back();
+	bullets.directionY.pop_back();
+	bullets.speed.pop_back();
+	bullets.type.pop_back();
+	bullets.id.pop_back();
+}
+
+sf::Vector2f BulletNode::getAimTarget(sf::Vector2f origin) const
+{
+	// Nearest living player, or straight down if there is none
+	sf::Vector2f target = origin + sf::Vector2f(0.f, 1.f);
+	float minDistance = std::numeric_limits<float>::max();
+
+	FOREACH(const Aircraft* player, mPlayers)
+	{
+		if (player->isDestroyed())
+			continue;
+
+		sf::Vector2f position = player->getWorldPosition();
+		float playerDistance = length(position - origin);
+		if (playerDistance < minDistance)
+		{
+			target = position;
+			minDistance = playerDistance;
+		}
+	}
+
+	return target;
+}
+
+void BulletNode::computeVertices() const
+{
+	mVertexArray.resize(4 * getBulletCount());
+	sf::Vertex* quad = &mVertexArray[0];
+
+	FOREACH(const Bullets& bullets, mBullets)
+	{
+		for (std::size_t i = 0; i < bullets.positionX.size(); ++i, quad += 4)
+		{
+			// Quads are oriented along the flight direction, the texture is drawn pointing down
+			const sf::IntRect& rect = Table[bullets.type[i]].textureRect;
+			float halfWidth = rect.width / 2.f;
+			float halfLength = rect.height / 2.f;
+
+			sf::Vector2f center(bullets.positionX[i], bullets.positionY[i]);
+			sf::Vector2f forward(bullets.directionX[i] * halfLength, bullets.directionY[i] * halfLength);
+			sf::Vector2f side(bullets.directionY[i] * halfWidth, -bullets.directionX[i] * halfWidth);
+
+			quad[0].position = center - forward - side;
+			quad[1].position = center - forward + side;
+			quad[2].position = center + forward + side;
+			quad[3].position = center + forward - side;
+
+			float left = static_cast<float>(rect.left);
+			float top = static_cast<float>(rect.top);
+			quad[0].texCoords = sf::Vector2f(left, top);
+			quad[1].texCoords = sf::Vector2f(left + rect.width, top);
+			quad[2].texCoords = sf::Vector2f(left + rect.width, top + rect.height);
+			quad[3].texCoords = sf::Vector2f(left, top + rect.height);
+		}
+	}
+}
+
+BulletNode::Side BulletNode::getSide(Projectile::Type type)
+{
+	return (type == Projectile::AlliedBullet) ? Allied : Enemy;
+}
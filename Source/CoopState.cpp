@@ -0,0 +1,96 @@
+#include "CoopState.hpp"
+#include "MusicPlayer.hpp"
+#include "ResourceHolder.hpp"
+#include "Utility.hpp"
+
+#include <SFML/Graphics/RenderWindow.hpp>
+
+
+CoopState::CoopState(StateStack& stack, Context context)
+: State(stack, context)
+, mWorld(*context.window, *context.fonts, *context.sounds)
+, mFirstPlayer(1)
+, mSecondPlayer(2)
+, mScoreText()
+{
+	mWorld.addAircraft(2);
+	mWorld.setSplitScreen(true);
+
+	// The first player keeps the keys chosen in the settings, the second one flies on the left side of the keyboard
+	for (int action = 0; action < Player::ActionCount; ++action)
+	{
+		Player::Action playerAction = static_cast<Player::Action>(action);
+		mFirstPlayer.assignKey(playerAction, context.player->getAssignedKey(playerAction));
+	}
+
+	mSecondPlayer.assignKey(Player::MoveLeft, sf::Keyboard::A);
+	mSecondPlayer.assignKey(Player::MoveRight, sf::Keyboard::D);
+	mSecondPlayer.assignKey(Player::MoveUp, sf::Keyboard::W);
+	mSecondPlayer.assignKey(Player::MoveDown, sf::Keyboard::S);
+	mSecondPlayer.assignKey(Player::Fire, sf::Keyboard::LControl);
+	mSecondPlayer.assignKey(Player::LaunchMissile, sf::Keyboard::LShift);
+
+	context.player->setMissionStatus(Player::MissionRunning);
+
+	mScoreText.setFont(context.fonts->get(Fonts::Arcade));
+	mScoreText.setPosition(700.f, 725.f);
+	mScoreText.setCharacterSize(20u);
+
+	int level = World::getLevel()-1;
+	if(level==1) context.music->play(Music::Level_1);
+	else if(level==2) context.music->play(Music::Level_2);
+	else if(level==3) context.music->play(Music::Level_3);
+	if (level == 4) context.music->play(Music::Level_4);
+}
+
+void CoopState::draw()
+{
+	mWorld.draw();
+
+	sf::RenderWindow& window = *getContext().window;
+	window.setView(window.getDefaultView());
+	window.draw(mScoreText);
+}
+
+bool CoopState::update(sf::Time dt)
+{
+	mWorld.update(dt);
+	mScoreText.setString("Score: " + toString(World::getScore()));
+
+	// The game goes on as long as one of the two is still flying
+	if (!mWorld.hasAlivePlayer())
+	{
+		getContext().player->setMissionStatus(Player::MissionFailure);
+		requestStackPop();
+		requestStackPush(States::GameOver);
+	}
+	else if (mWorld.hasPlayerReachedEnd())
+	{
+		getContext().player->setMissionStatus(Player::MissionSuccess);
+		requestStackPop();
+		World::increaseScore();
+		if (World::getLevel()==5)
+			requestStackPush(States::GameOver);
+		else
+			requestStackPush(States::Coop);
+	}
+
+	CommandQueue& commands = mWorld.getCommandQueue();
+	mFirstPlayer.handleRealtimeInput(commands);
+	mSecondPlayer.handleRealtimeInput(commands);
+
+	return true;
+}
+
+bool CoopState::handleEvent(const sf::Event& event)
+{
+	CommandQueue& commands = mWorld.getCommandQueue();
+	mFirstPlayer.handleEvent(event, commands);
+	mSecondPlayer.handleEvent(event, commands);
+
+	// Escape pressed, trigger the pause screen
+	if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
+		requestStackPush(States::Pause);
+
+	return true;
+}
@@ -49,6 +49,16 @@ std::vector<AircraftData> initializeAircraftData()
 	data[Aircraft::C83].fireInterval = sf::seconds(3);
 	data[Aircraft::C83].hasRollAnimation = false;
 
+	// Boss volleys: a radial ring, then a spiral, then aimed fans at the player
+	data[Aircraft::C83].bulletPattern.cycle = sf::seconds(6.f);
+	data[Aircraft::C83].bulletPattern.emitters.push_back(BulletEmitter(  0.f, 22.5f, 16, 120.f,   0.f, sf::seconds(0.25f), sf::seconds(0.f), sf::seconds(2.f), false));
+	data[Aircraft::C83].bulletPattern.emitters.push_back(BulletEmitter(  0.f, 120.f,  3, 150.f, 150.f, sf::seconds(0.05f), sf::seconds(2.f), sf::seconds(4.f), false));
+	data[Aircraft::C83].bulletPattern.emitters.push_back(BulletEmitter(  0.f,  10.f,  5, 200.f,   0.f, sf::seconds(0.2f),  sf::seconds(4.f), sf::seconds(6.f), true));
+
+	// Enemies fly their direction lists as behavior scripts, formations still follow the directions themselves
+	for (std::size_t i = 0; i < data.size(); ++i)
+		data[i].behavior = Behavior::fromDirections(data[i].directions);
+
 	return data;
 }
 
@@ -71,6 +81,12 @@ std::vector<ProjectileData> initializeProjectileData()
 	data[Projectile::Missile].texture = Textures::Entities;
 	data[Projectile::Missile].textureRect = sf::IntRect(160, 64, 15, 32);
 
+	// Boss patterns fire these by the hundred with their own speeds, a single one only scratches
+	data[Projectile::PatternBullet].damage = 2;
+	data[Projectile::PatternBullet].speed = 150.f;
+	data[Projectile::PatternBullet].texture = Textures::Entities;
+	data[Projectile::PatternBullet].textureRect = sf::IntRect(178, 64, 3, 14);
+
 	return data;
 }
 
@@ -107,9 +123,17 @@ std::vector<ParticleData> initializeParticleData()
 
 	data[Particle::Propellant].color = sf::Color(255, 255, 50);
 	data[Particle::Propellant].lifetime = sf::seconds(0.6f);
+	data[Particle::Propellant].drag = 4.f;
+	data[Particle::Propellant].capacity = 2048;
+	data[Particle::Propellant].budget = 1536;
+	data[Particle::Propellant].emissionRate = 30.f;
 
 	data[Particle::Smoke].color = sf::Color(50, 50, 50);
 	data[Particle::Smoke].lifetime = sf::seconds(4.f);
+	data[Particle::Smoke].drag = 1.f;
+	data[Particle::Smoke].capacity = 8192;
+	data[Particle::Smoke].budget = 6144;
+	data[Particle::Smoke].emissionRate = 30.f;
 
 	return data;
 }
@@ -1,50 +1,61 @@
 #include "EmitterNode.hpp"
 #include "ParticleNode.hpp"
-#include "CommandQueue.hpp"
-#include "Command.hpp"
 
 
-EmitterNode::EmitterNode(Particle::Type type)
-: SceneNode()
-, mAccumulatedTime(sf::Time::Zero)
-, mType(type)
-, mParticleSystem(nullptr)
+namespace
 {
+	// How often an emitter that got no share of the particle budget asks again
+	const sf::Time IdleInterval = sf::seconds(0.25f);
 }
 
-void EmitterNode::updateCurrent(sf::Time dt, CommandQueue& commands)
+EmitterNode::EmitterNode(Particle::Type type, const SceneNode& carrier, TimerWheel& timers, ParticleRegistry& particles)
+: SceneNode()
+, mCarrier(carrier)
+, mTimers(timers)
+, mEmissionTimer(TimerWheel::InvalidID)
+, mParticleSystem(particles.get(type))
+, mCarrierTransform()
+, mNeedsCarrierTransform(true)
 {
+	// Emission is driven by the timer wheel alone, the first particle follows on the next tick
 	if (mParticleSystem)
 	{
-		emitParticles(dt);
-	}
-	else
-	{
-		// Find particle node with the same type as emitter node
-		auto finder = [this] (ParticleNode& container, sf::Time)
+		mEmissionTimer = mTimers.schedule(sf::Time::Zero, [this] ()
 		{
-			if (container.getParticleType() == mType)
-				mParticleSystem = &container;
-		};
-
-		Command command;
-		command.category = Category::ParticleSystem;
-		command.action = derivedAction<ParticleNode>(finder);
-
-		commands.push(command);
+			emitParticles();
+		});
 	}
 }
 
-void EmitterNode::emitParticles(sf::Time dt)
+EmitterNode::~EmitterNode()
 {
-	const float emissionRate = 30.f;
-	const sf::Time interval = sf::seconds(1.f) / emissionRate;
+	mTimers.cancel(mEmissionTimer);
+}
 
-	mAccumulatedTime += dt;
+void EmitterNode::updateCurrent(sf::Time, CommandQueue&)
+{
+	// The carrier moves from here on, the timers of the next tick look its transform up again
+	mNeedsCarrierTransform = true;
+}
 
-	while (mAccumulatedTime > interval)
+void EmitterNode::emitParticles()
+{
+	// All particles of a tick are emitted before the scene update, so they share the carrier's transform
+	if (mNeedsCarrierTransform)
 	{
-		mAccumulatedTime -= interval;
-		mParticleSystem->addParticle(getWorldPosition());
+		mCarrierTransform = mCarrier.getWorldTransform();
+		mNeedsCarrierTransform = false;
 	}
+
+	// The budget decides how often this emitter may emit, when it gets nothing it pauses for a while
+	sf::Vector2f position = mCarrierTransform * getPosition();
+	float rate = mParticleSystem->getEmissionRate(position);
+	if (rate > 0.f)
+		mParticleSystem->addParticle(position);
+
+	// Re-arm for the next particle
+	mEmissionTimer = mTimers.schedule(rate > 0.f ? sf::seconds(1.f / rate) : IdleInterval, [this] ()
+	{
+		emitParticles();
+	});
 }
@@ -0,0 +1,139 @@
+#include "EndlessGenerator.hpp"
+#include "Aircraft.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+namespace
+{
+	// Chunks until the waves reach full strength
+	const float RampChunks = 40.f;
+
+	const std::size_t MinWaves = 2;
+	const std::size_t ExtraWaves = 3;
+	const std::size_t MinWaveSize = 3;
+	const std::size_t ExtraWaveSize = 4;
+
+	// Enemies stay this far from the center, like in the campaign levels
+	const float MaxOffset = 420.f;
+	const float WaveDepth = 160.f;
+
+	// Swarms show up once the run gets going, and grow with the difficulty
+	const float SwarmChance = 0.15f;
+	const std::size_t MinSwarmSize = 40;
+	const std::size_t ExtraSwarmSize = 160;
+
+	LevelFormat::Spawn makeSpawn(Aircraft::Type type, std::uint8_t pattern, float x, float distance)
+	{
+		LevelFormat::Spawn spawn;
+		std::memset(&spawn, 0, sizeof(spawn));
+
+		spawn.distance = distance;
+		spawn.x = x;
+		spawn.type = static_cast<std::uint8_t>(type);
+		spawn.pattern = pattern;
+
+		return spawn;
+	}
+}
+
+const float EndlessGenerator::ChunkHeight = 1200.f;
+
+EndlessGenerator::EndlessGenerator(unsigned long seed)
+: mSeed(seed)
+{
+}
+
+void EndlessGenerator::generateChunk(std::size_t index, std::vector<LevelFormat::Spawn>& spawns) const
+{
+	spawns.clear();
+
+	std::seed_seq sequence = { static_cast<std::uint32_t>(mSeed), static_cast<std::uint32_t>(index) };
+	std::mt19937 random(sequence);
+
+	float difficulty = std::min(static_cast<float>(index) / RampChunks, 1.f);
+	std::size_t waveCount = MinWaves + static_cast<std::size_t>(std::floor(ExtraWaves * difficulty + 0.5f));
+
+	// Every wave gets an own slice of the chunk, so waves never overlap
+	float slice = ChunkHeight / waveCount;
+	std::uniform_real_distribution<float> offset(0.f, slice - WaveDepth);
+	for (std::size_t i = 0; i < waveCount; ++i)
+		addWave(random, i * slice + offset(random), difficulty, spawns);
+
+	std::stable_sort(spawns.begin(), spawns.end(), [] (const LevelFormat::Spawn& lhs, const LevelFormat::Spawn& rhs)
+	{
+		return lhs.distance < rhs.distance;
+	});
+}
+
+unsigned long EndlessGenerator::getSeed() const
+{
+	return mSeed;
+}
+
+void EndlessGenerator::addWave(std::mt19937& random, float distance, float difficulty, std::vector<LevelFormat::Spawn>& spawns) const
+{
+	std::uniform_real_distribution<float> chance(0.f, 1.f);
+
+	if (chance(random) < SwarmChance * difficulty)
+	{
+		LevelFormat::Spawn swarm = makeSpawn(Aircraft::Raptor, LevelFormat::OwnPattern, 0.f, distance);
+		swarm.type = LevelFormat::SwarmType;
+		swarm.count = static_cast<std::uint16_t>(MinSwarmSize + static_cast<std::size_t>(ExtraSwarmSize * difficulty));
+		spawns.push_back(swarm);
+		return;
+	}
+
+	// Raptors early on, Avengers take over, and later some unkillable C83 block the way
+	float roll = chance(random);
+	Aircraft::Type type = Aircraft::Raptor;
+	if (roll < 0.15f * difficulty)
+		type = Aircraft::C83;
+	else if (roll < 0.2f + 0.5f * difficulty)
+		type = Aircraft::Avenger;
+
+	std::uint8_t pattern = LevelFormat::OwnPattern;
+	if (chance(random) < 0.3f * difficulty)
+		pattern = static_cast<std::uint8_t>(chance(random) < 0.5f ? Aircraft::Raptor : Aircraft::Avenger);
+
+	std::size_t size = MinWaveSize + static_cast<std::size_t>(ExtraWaveSize * difficulty * chance(random) + 0.5f);
+	Formation formation = static_cast<Formation>(std::uniform_int_distribution<int>(0, FormationCount - 1)(random));
+
+	// Narrow formations are shifted sideways at random
+	float width = std::min(2.f * MaxOffset, 120.f * size);
+	float center = std::uniform_real_distribution<float>(-(MaxOffset - width / 2.f), MaxOffset - width / 2.f)(random);
+	float step = size > 1 ? 1.f / (size - 1) : 0.f;
+
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		float t = i * step;
+		float x = center + (t - 0.5f) * width;
+		float depth = 0.f;
+
+		switch (formation)
+		{
+			case Row:
+				break;
+
+			case Vee:
+				depth = std::abs(t - 0.5f) * 2.f * WaveDepth;
+				break;
+
+			case Columns:
+				x = center + ((i % 2 == 0) ? -0.5f : 0.5f) * width;
+				depth = (i / 2) * WaveDepth / ((size + 1) / 2);
+				break;
+
+			case Diagonal:
+				depth = t * WaveDepth;
+				break;
+
+			case FormationCount:
+				break;
+		}
+
+		spawns.push_back(makeSpawn(type, pattern, x, distance + depth));
+	}
+}
@@ -0,0 +1,93 @@
+#include "EndlessState.hpp"
+#include "MusicPlayer.hpp"
+#include "ResourceHolder.hpp"
+#include "Utility.hpp"
+
+#include <SFML/Graphics/RenderWindow.hpp>
+
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+
+EndlessState::EndlessState(StateStack& stack, Context context)
+: State(stack, context)
+, mWorld(*context.window, *context.fonts, *context.sounds, World::Endless, loadSeed("Endless.txt"))
+, mPlayer(*context.player)
+, mScoreText()
+, mSeedText()
+{
+	mPlayer.setMissionStatus(Player::MissionRunning);
+
+	mScoreText.setFont(context.fonts->get(Fonts::Arcade));
+	mScoreText.setPosition(700.f, 725.f);
+	mScoreText.setCharacterSize(20u);
+
+	// Shown so that a good run can be played again with "seed <number>" in Endless.txt
+	mSeedText.setFont(context.fonts->get(Fonts::Main));
+	mSeedText.setPosition(5.f, 25.f);
+	mSeedText.setCharacterSize(10u);
+	mSeedText.setString("Seed: " + toString(mWorld.getSeed()));
+
+	context.music->play(Music::Level_1);
+}
+
+void EndlessState::draw()
+{
+	mWorld.draw();
+
+	sf::RenderWindow& window = *getContext().window;
+	window.setView(window.getDefaultView());
+	window.draw(mScoreText);
+	window.draw(mSeedText);
+}
+
+bool EndlessState::update(sf::Time dt)
+{
+	mWorld.update(dt);
+	mScoreText.setString("Score: " + toString(World::getScore()));
+
+	if (!mWorld.hasAlivePlayer())
+	{
+		mPlayer.setMissionStatus(Player::MissionFailure);
+		requestStackPop();
+		requestStackPush(States::GameOver);
+	}
+
+	CommandQueue& commands = mWorld.getCommandQueue();
+	mPlayer.handleRealtimeInput(commands);
+
+	return true;
+}
+
+bool EndlessState::handleEvent(const sf::Event& event)
+{
+	CommandQueue& commands = mWorld.getCommandQueue();
+	mPlayer.handleEvent(event, commands);
+
+	// Escape pressed, trigger the pause screen
+	if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
+		requestStackPush(States::Pause);
+
+	return true;
+}
+
+unsigned long EndlessState::loadSeed(const std::string& filename)
+{
+	// Optional file of "key value" lines, without a seed every run is different
+	unsigned long seed = static_cast<unsigned long>(std::time(nullptr));
+
+	std::ifstream file(filename);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		std::string key;
+		stream >> key;
+
+		if (key == "seed")
+			stream >> seed;
+	}
+
+	return seed;
+}
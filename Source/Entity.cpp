@@ -1,15 +1,31 @@
 #include "Entity.hpp"
+#include "Snapshot.hpp"
 
 #include <cassert>
 
 
 
 Entity::Entity(int hitpoints)
-: mVelocity()
+: mEntityId(mNextEntityId++)
+, mVelocity()
 , mHitpoints(hitpoints)
 {
 }
 
+Entity::Entity(int hitpoints, sf::Uint32 id)
+: mEntityId(id)
+, mVelocity()
+, mHitpoints(hitpoints)
+{
+}
+
+void Entity::respawn(int hitpoints)
+{
+	mEntityId = mNextEntityId++;
+	mVelocity = sf::Vector2f();
+	mHitpoints = hitpoints;
+}
+
 void Entity::setVelocity(sf::Vector2f velocity)
 {
 	mVelocity = velocity;
@@ -76,3 +92,38 @@ void Entity::updateCurrent(sf::Time dt, CommandQueue&)
 {	
 	move(mVelocity * dt.asSeconds());
 }
+
+sf::Uint32 Entity::getEntityId() const
+{
+	return mEntityId;
+}
+
+void Entity::saveState(EntityState& state) const
+{
+	state.id = mEntityId;
+	state.position = getPosition();
+	state.velocity = mVelocity;
+	state.rotation = getRotation();
+	state.hitpoints = mHitpoints;
+}
+
+void Entity::loadState(const EntityState& state)
+{
+	mEntityId = state.id;
+	setPosition(state.position);
+	setRotation(state.rotation);
+	mVelocity = state.velocity;
+	mHitpoints = state.hitpoints;
+}
+
+sf::Uint32 Entity::getNextEntityId()
+{
+	return mNextEntityId;
+}
+
+void Entity::setNextEntityId(sf::Uint32 id)
+{
+	mNextEntityId = id;
+}
+
+sf::Uint32 Entity::mNextEntityId = 1;
@@ -0,0 +1,118 @@
+#include "ExplosionNode.hpp"
+#include "ResourceHolder.hpp"
+#include "Foreach.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+
+
+ExplosionNode::ExplosionNode(const AnimationHolder& animations)
+: SceneNode()
+, mClip(animations.get(Animations::Explosion))
+, mExplosions()
+, mElapsedTime(sf::Time::Zero)
+, mVertexArray(sf::Quads)
+, mNeedsVertexUpdate(true)
+{
+}
+
+void ExplosionNode::addExplosion(sf::Vector2f position)
+{
+	Explosion explosion;
+	explosion.position = position;
+	explosion.startTime = mElapsedTime;
+
+	mExplosions.push_back(explosion);
+	mNeedsVertexUpdate = true;
+}
+
+std::size_t ExplosionNode::getExplosionCount() const
+{
+	return mExplosions.size();
+}
+
+void ExplosionNode::saveState(std::vector<ExplosionState>& explosions) const
+{
+	explosions.resize(mExplosions.size());
+	for (std::size_t i = 0; i < mExplosions.size(); ++i)
+	{
+		explosions[i].position = mExplosions[i].position;
+		explosions[i].age = mElapsedTime - mExplosions[i].startTime;
+	}
+}
+
+void ExplosionNode::loadState(const std::vector<ExplosionState>& explosions)
+{
+	// A rollback replays the explosions of the frames after the snapshot, they must not play twice
+	mExplosions.resize(explosions.size());
+	for (std::size_t i = 0; i < explosions.size(); ++i)
+	{
+		mExplosions[i].position = explosions[i].position;
+		mExplosions[i].startTime = mElapsedTime - explosions[i].age;
+	}
+
+	mNeedsVertexUpdate = true;
+}
+
+unsigned int ExplosionNode::getCategory() const
+{
+	return Category::ExplosionSystem;
+}
+
+void ExplosionNode::translateOrigin(sf::Vector2f offset)
+{
+	FOREACH(Explosion& explosion, mExplosions)
+		explosion.position += offset;
+
+	mNeedsVertexUpdate = true;
+}
+
+void ExplosionNode::updateCurrent(sf::Time dt, CommandQueue&)
+{
+	mElapsedTime += dt;
+	if (mExplosions.empty())
+		return;
+
+	// All explosions last equally long, so the finished ones are always the oldest
+	auto finished = std::find_if(mExplosions.begin(), mExplosions.end(), [this] (const Explosion& explosion)
+	{
+		return !mClip.isFinished(mElapsedTime - explosion.startTime);
+	});
+	mExplosions.erase(mExplosions.begin(), finished);
+
+	mNeedsVertexUpdate = true;
+}
+
+void ExplosionNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if (mNeedsVertexUpdate)
+	{
+		computeVertices();
+		mNeedsVertexUpdate = false;
+	}
+
+	states.texture = &mClip.getTexture();
+	target.draw(mVertexArray, states);
+}
+
+void ExplosionNode::computeVertices() const
+{
+	sf::Vector2f half = sf::Vector2f(mClip.getFrameSize()) / 2.f;
+
+	mVertexArray.resize(mExplosions.size() * 4);
+	for (std::size_t i = 0; i < mExplosions.size(); ++i)
+	{
+		const Explosion& explosion = mExplosions[i];
+
+		sf::FloatRect rect(mClip.getFrame(mElapsedTime - explosion.startTime));
+		sf::Vector2f pos = explosion.position;
+
+		sf::Vertex* quad = &mVertexArray[i * 4];
+		quad[0] = sf::Vertex(sf::Vector2f(pos.x - half.x, pos.y - half.y), sf::Vector2f(rect.left,              rect.top));
+		quad[1] = sf::Vertex(sf::Vector2f(pos.x + half.x, pos.y - half.y), sf::Vector2f(rect.left + rect.width, rect.top));
+		quad[2] = sf::Vertex(sf::Vector2f(pos.x + half.x, pos.y + half.y), sf::Vector2f(rect.left + rect.width, rect.top + rect.height));
+		quad[3] = sf::Vertex(sf::Vector2f(pos.x - half.x, pos.y + half.y), sf::Vector2f(rect.left,              rect.top + rect.height));
+	}
+}
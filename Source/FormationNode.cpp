@@ -0,0 +1,137 @@
+#include "FormationNode.hpp"
+#include "DataTables.hpp"
+#include "Snapshot.hpp"
+#include "Foreach.hpp"
+#include "Utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+	const std::vector<AircraftData> Table = initializeAircraftData();
+}
+
+FormationNode::FormationNode(const Aircraft& leader, Aircraft::Type pattern)
+: mLeaderId(leader.getEntityId())
+, mVelocity()
+, mSpeed(leader.getMaxSpeed())
+, mPattern(pattern)
+, mDirectionIndex(0)
+, mTravelledDistance(0.f)
+{
+	setPosition(leader.getPosition());
+	updateVelocity();
+}
+
+FormationNode::FormationNode(const FormationState& state)
+: mLeaderId(state.id)
+, mVelocity(state.velocity)
+, mSpeed(state.speed)
+, mPattern(static_cast<Aircraft::Type>(state.pattern))
+, mDirectionIndex(state.directionIndex)
+, mTravelledDistance(state.travelledDistance)
+{
+	setPosition(state.position);
+}
+
+void FormationNode::addMember(AircraftPtr member)
+{
+	// Members keep their offset, and report the formation's velocity as their own
+	member->setPosition(member->getPosition() - getPosition());
+	member->setVelocity(mVelocity);
+	member->setFormation(mLeaderId);
+
+	attachChild(std::move(member));
+}
+
+void FormationNode::release(SceneNode& layer)
+{
+	// Every member takes over the position and the movement pattern where the formation left off,
+	// finishing the current leg before its own script takes over
+	const std::vector<Direction>& directions = Table[mPattern].directions;
+	sf::Time remaining = sf::Time::Zero;
+	if (!directions.empty() && mSpeed > 0.f)
+		remaining = sf::seconds(std::max(directions[mDirectionIndex].distance - mTravelledDistance, 0.f) / mSpeed);
+
+	while (!getChildren().empty())
+	{
+		Ptr child = detachChild(*getChildren().front());
+		Aircraft& aircraft = static_cast<Aircraft&>(*child);
+
+		aircraft.setPosition(aircraft.getPosition() + getPosition());
+		aircraft.setFormation(0);
+		aircraft.setMovementPattern(mPattern, mDirectionIndex + 1, remaining);
+
+		layer.attachChild(std::move(child));
+	}
+}
+
+sf::Uint32 FormationNode::getId() const
+{
+	return mLeaderId;
+}
+
+bool FormationNode::isBroken() const
+{
+	FOREACH(const Ptr& child, getChildren())
+	{
+		const Aircraft& aircraft = static_cast<const Aircraft&>(*child);
+		if (aircraft.getEntityId() == mLeaderId)
+			return aircraft.isDestroyed();
+	}
+
+	// The leader has left the battlefield
+	return true;
+}
+
+bool FormationNode::isEmpty() const
+{
+	return getChildren().empty();
+}
+
+bool FormationNode::isMarkedForRemoval() const
+{
+	return isEmpty();
+}
+
+void FormationNode::saveState(FormationState& state) const
+{
+	state.id = mLeaderId;
+	state.position = getPosition();
+	state.velocity = mVelocity;
+	state.speed = mSpeed;
+	state.pattern = static_cast<sf::Uint8>(mPattern);
+	state.directionIndex = static_cast<sf::Uint32>(mDirectionIndex);
+	state.travelledDistance = mTravelledDistance;
+}
+
+void FormationNode::updateCurrent(sf::Time dt, CommandQueue&)
+{
+	// Same movement pattern as Aircraft::updateMovementPattern(), but the velocity only changes with the direction
+	const std::vector<Direction>& directions = Table[mPattern].directions;
+	if (!directions.empty() && mTravelledDistance > directions[mDirectionIndex].distance)
+	{
+		mDirectionIndex = (mDirectionIndex + 1) % directions.size();
+		mTravelledDistance = 0.f;
+		updateVelocity();
+	}
+
+	move(mVelocity * dt.asSeconds());
+	mTravelledDistance += mSpeed * dt.asSeconds();
+}
+
+void FormationNode::updateVelocity()
+{
+	const std::vector<Direction>& directions = Table[mPattern].directions;
+	if (directions.empty())
+		return;
+
+	float radians = toRadian(directions[mDirectionIndex].angle + 90.f);
+	mVelocity = sf::Vector2f(mSpeed * std::cos(radians), mSpeed * std::sin(radians));
+
+	// Members fly along, their velocity drives the roll animation
+	FOREACH(const Ptr& child, getChildren())
+		static_cast<Aircraft&>(*child).setVelocity(mVelocity);
+}
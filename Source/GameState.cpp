@@ -1,5 +1,6 @@
 #include "GameState.hpp"
 #include "MusicPlayer.hpp"
+#include "Autopilot.hpp"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include "Utility.hpp"
@@ -13,7 +14,8 @@ GameState::GameState(StateStack& stack, Context context)
 , mScore(0)
 , mLevelText()
 , mShowText(true)
-, mTextEffectTime(sf::Time::Zero)
+, mPublisher()
+, mPublisherText()
 {
 	mPlayer.setMissionStatus(Player::MissionRunning);
 
@@ -26,6 +28,16 @@ GameState::GameState(StateStack& stack, Context context)
 	mScoreText.setPosition(700.f, 725.f);
 	mScoreText.setCharacterSize(20u);
 
+	mPublisherText.setFont(context.fonts->get(Fonts::Main));
+	mPublisherText.setPosition(5.f, 25.f);
+	mPublisherText.setCharacterSize(10u);
+
+	// Hide the level caption after a while
+	mWorld.getTimers().schedule(sf::seconds(4.5f), [this] ()
+	{
+		mShowText = false;
+	});
+
 	// Play game theme
 	int level = World::getLevel()-1;
 	if(level==1) context.music->play(Music::Level_1);
@@ -44,6 +56,8 @@ void GameState::draw()
 	window.draw(mScoreText);
 	if (mShowText)
 		window.draw(mLevelText);
+	if (mPublisher.isEnabled())
+		window.draw(mPublisherText);
 }
 
 bool GameState::update(sf::Time dt)
@@ -51,11 +65,13 @@ bool GameState::update(sf::Time dt)
 	mWorld.update(dt);
 	mScoreText.setString("Score: " + toString(World::getScore()));
 
-	mTextEffectTime += dt;
-
-	if (mTextEffectTime >= sf::seconds(4.5f))
+	if (mPublisher.isEnabled())
 	{
-		mShowText = false;
+		mPublisher.update(dt, mWorld);
+		mPublisherText.setString("Spectators: " + toString(mPublisher.getBytesPerSecond() / 1024.f) + " KB/s, "
+			+ toString(mPublisher.getFramesPerSecond()) + " frames/s\nEncoding: "
+			+ toString(mPublisher.getAverageEncodeTime().asMicroseconds()) + " us avg, "
+			+ toString(mPublisher.getMaxEncodeTime().asMicroseconds()) + " us max");
 	}
 
 
@@ -77,7 +93,10 @@ bool GameState::update(sf::Time dt)
 	}
 
 	CommandQueue& commands = mWorld.getCommandQueue();
-	mPlayer.handleRealtimeInput(commands);
+	if (getContext().autopilot)
+		getContext().autopilot->handleRealtimeInput(mWorld, commands);
+	else
+		mPlayer.handleRealtimeInput(commands);
 
 	return true;
 }
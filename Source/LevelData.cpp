@@ -0,0 +1,162 @@
+#include "LevelData.hpp"
+#include "Aircraft.hpp"
+#include "Utility.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+LevelData::LevelData()
+: mData(nullptr)
+, mSize(0)
+, mSpawns(nullptr)
+, mSpawnCount(0)
+#ifdef _WIN32
+, mFile(INVALID_HANDLE_VALUE)
+, mMapping(nullptr)
+#endif
+{
+}
+
+LevelData::~LevelData()
+{
+	unmap();
+}
+
+void LevelData::loadFromFile(const std::string& filename)
+{
+	unmap();
+	map(filename);
+
+	LevelFormat::Header header;
+	if (mSize < sizeof(header))
+		throw std::runtime_error("LevelData::loadFromFile - " + filename + " is too short");
+
+	std::memcpy(&header, mData, sizeof(header));
+	if (std::memcmp(header.magic, LevelFormat::Magic, sizeof(header.magic)) != 0 || header.version != LevelFormat::Version)
+		throw std::runtime_error("LevelData::loadFromFile - " + filename + " is not a level file of version " + toString(LevelFormat::Version));
+
+	if (mSize != sizeof(header) + header.spawnCount * sizeof(LevelFormat::Spawn))
+		throw std::runtime_error("LevelData::loadFromFile - " + filename + " has a wrong size");
+
+	// The header keeps the spawns 4-byte aligned within the page-aligned mapping
+	mSpawns = reinterpret_cast<const LevelFormat::Spawn*>(mData + sizeof(header));
+	mSpawnCount = header.spawnCount;
+
+	// The converter sorts the spawns, World relies on that order
+	for (std::size_t i = 0; i < mSpawnCount; ++i)
+	{
+		if ((mSpawns[i].type >= Aircraft::TypeCount && mSpawns[i].type != LevelFormat::SwarmType)
+			|| (mSpawns[i].pattern >= Aircraft::TypeCount && mSpawns[i].pattern != LevelFormat::OwnPattern)
+			|| (i > 0 && mSpawns[i].distance < mSpawns[i - 1].distance))
+			throw std::runtime_error("LevelData::loadFromFile - " + filename + " has an invalid spawn at index " + toString(i));
+	}
+}
+
+std::size_t LevelData::getSpawnCount() const
+{
+	return mSpawnCount;
+}
+
+const LevelFormat::Spawn* LevelData::getSpawns() const
+{
+	return mSpawns;
+}
+
+const LevelFormat::Spawn& LevelData::getSpawn(std::size_t index) const
+{
+	assert(index < mSpawnCount);
+	return mSpawns[index];
+}
+
+#ifdef _WIN32
+
+void LevelData::map(const std::string& filename)
+{
+	mFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (mFile == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("LevelData::loadFromFile - Failed to load " + filename);
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0)
+	{
+		unmap();
+		throw std::runtime_error("LevelData::loadFromFile - " + filename + " is empty");
+	}
+
+	mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	mData = mMapping ? static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+	if (!mData)
+	{
+		unmap();
+		throw std::runtime_error("LevelData::loadFromFile - Failed to map " + filename);
+	}
+
+	mSize = static_cast<std::size_t>(size.QuadPart);
+}
+
+void LevelData::unmap()
+{
+	if (mData)
+		UnmapViewOfFile(mData);
+	if (mMapping)
+		CloseHandle(mMapping);
+	if (mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
+
+	mData = nullptr;
+	mMapping = nullptr;
+	mFile = INVALID_HANDLE_VALUE;
+	mSize = 0;
+	mSpawns = nullptr;
+	mSpawnCount = 0;
+}
+
+#else
+
+void LevelData::map(const std::string& filename)
+{
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		throw std::runtime_error("LevelData::loadFromFile - Failed to load " + filename);
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close(file);
+		throw std::runtime_error("LevelData::loadFromFile - " + filename + " is empty");
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (data == MAP_FAILED)
+		throw std::runtime_error("LevelData::loadFromFile - Failed to map " + filename);
+
+	mData = static_cast<const char*>(data);
+	mSize = static_cast<std::size_t>(status.st_size);
+}
+
+void LevelData::unmap()
+{
+	if (mData)
+		munmap(const_cast<char*>(mData), mSize);
+
+	mData = nullptr;
+	mSize = 0;
+	mSpawns = nullptr;
+	mSpawnCount = 0;
+}
+
+#endif
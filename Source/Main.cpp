@@ -4,11 +4,11 @@
 #include <iostream>
 
 
-int main()
+int main(int argc, char* argv[])
 {
 	try
 	{
-		Application app;
+		Application app(argc, argv);
 		app.run();
 	}
 	catch (std::exception& e)
@@ -4,6 +4,7 @@
 #include "MusicPlayer.hpp"
 #include "ResourceHolder.hpp"
 #include "World.hpp"
+#include "Autopilot.hpp"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/View.hpp>
@@ -17,7 +18,7 @@ MenuState::MenuState(StateStack& stack, Context context)
 	mBackgroundSprite.setTexture(texture);
 
 	auto playButton = std::make_shared<GUI::Button>(context);
-	playButton->setPosition(412, 550);
+	playButton->setPosition(412, 400);
 	playButton->setText("Play");
 	playButton->setCallback([this] ()
 	{
@@ -26,8 +27,47 @@ MenuState::MenuState(StateStack& stack, Context context)
 		requestStackPush(States::Game);
 	});
 
+	auto endlessButton = std::make_shared<GUI::Button>(context);
+	endlessButton->setPosition(412, 450);
+	endlessButton->setText("Endless");
+	endlessButton->setCallback([this] ()
+	{
+		requestStackPop();
+		World::updateGame();
+		requestStackPush(States::Endless);
+	});
+
+	auto coopButton = std::make_shared<GUI::Button>(context);
+	coopButton->setPosition(412, 500);
+	coopButton->setText("Co-op");
+	coopButton->setCallback([this] ()
+	{
+		requestStackPop();
+		World::updateGame();
+		requestStackPush(States::Coop);
+	});
+
+	auto netplayButton = std::make_shared<GUI::Button>(context);
+	netplayButton->setPosition(412, 550);
+	netplayButton->setText("Netplay");
+	netplayButton->setCallback([this] ()
+	{
+		requestStackPop();
+		World::updateGame();
+		requestStackPush(States::Netplay);
+	});
+
+	auto spectateButton = std::make_shared<GUI::Button>(context);
+	spectateButton->setPosition(412, 600);
+	spectateButton->setText("Spectate");
+	spectateButton->setCallback([this] ()
+	{
+		requestStackPop();
+		requestStackPush(States::Spectator);
+	});
+
 	auto settingsButton = std::make_shared<GUI::Button>(context);
-	settingsButton->setPosition(412, 600);
+	settingsButton->setPosition(412, 650);
 	settingsButton->setText("Settings");
 	settingsButton->setCallback([this] ()
 	{
@@ -35,7 +75,7 @@ MenuState::MenuState(StateStack& stack, Context context)
 	});
 
 	auto exitButton = std::make_shared<GUI::Button>(context);
-	exitButton->setPosition(412, 650);
+	exitButton->setPosition(412, 700);
 	exitButton->setText("Exit");
 	exitButton->setCallback([this] ()
 	{
@@ -43,6 +83,10 @@ MenuState::MenuState(StateStack& stack, Context context)
 	});
 
 	mGUIContainer.pack(playButton);
+	mGUIContainer.pack(endlessButton);
+	mGUIContainer.pack(coopButton);
+	mGUIContainer.pack(netplayButton);
+	mGUIContainer.pack(spectateButton);
 	mGUIContainer.pack(settingsButton);
 	mGUIContainer.pack(exitButton);
 
@@ -62,6 +106,18 @@ void MenuState::draw()
 
 bool MenuState::update(sf::Time)
 {
+	// Unattended runs start the next game right away, and quit once all of them are done
+	Autopilot* autopilot = getContext().autopilot;
+	if (autopilot)
+	{
+		requestStackPop();
+		if (autopilot->startRun())
+		{
+			World::updateGame();
+			requestStackPush(States::Game);
+		}
+	}
+
 	return true;
 }
 
@@ -0,0 +1,177 @@
+#include "NetplayState.hpp"
+#include "MusicPlayer.hpp"
+#include "ResourceHolder.hpp"
+#include "Utility.hpp"
+
+#include <SFML/Graphics/RenderWindow.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace
+{
+	// Both machines have to start from the same random numbers
+	const unsigned long NetplaySeed = 2000;
+}
+
+NetplayState::Settings::Settings()
+: player(1)
+, remoteAddress("127.0.0.1")
+, port(50001)
+, latency(sf::Time::Zero)
+, loss(0.f)
+{
+}
+
+NetplayState::NetplayState(StateStack& stack, Context context)
+: State(stack, context)
+, mSettings(loadSettings("Netplay.txt"))
+, mWorld(*context.window, *context.fonts, *context.sounds)
+, mLocalPlayer(mSettings.player)
+, mRemotePlayer(3 - mSettings.player)
+, mLink()
+, mSession(mWorld, mLocalPlayer, mRemotePlayer, mLink, *context.sounds)
+, mScoreText()
+, mStatisticsText()
+{
+	getRandomEngine().seed(NetplaySeed);
+	mWorld.addAircraft(2);
+
+	// Player 1 listens on the base port and player 2 on the one after it, so the same file works on loopback
+	unsigned short localPort = static_cast<unsigned short>(mSettings.port + mSettings.player - 1);
+	unsigned short remotePort = static_cast<unsigned short>(mSettings.port + 2 - mSettings.player);
+
+	if (!mLink.bind(localPort))
+		throw std::runtime_error("NetplayState - Failed to bind port " + toString(localPort));
+
+	mLink.setRemote(sf::IpAddress(mSettings.remoteAddress), remotePort);
+	mLink.setSimulatedLatency(mSettings.latency);
+	mLink.setSimulatedLoss(mSettings.loss);
+
+	// The local player keeps the keys chosen in the settings
+	for (int action = 0; action < Player::ActionCount; ++action)
+	{
+		Player::Action playerAction = static_cast<Player::Action>(action);
+		mLocalPlayer.assignKey(playerAction, context.player->getAssignedKey(playerAction));
+	}
+
+	mScoreText.setFont(context.fonts->get(Fonts::Arcade));
+	mScoreText.setPosition(700.f, 725.f);
+	mScoreText.setCharacterSize(20u);
+
+	mStatisticsText.setFont(context.fonts->get(Fonts::Main));
+	mStatisticsText.setPosition(5.f, 25.f);
+	mStatisticsText.setCharacterSize(10u);
+
+	context.music->play(Music::Level_1);
+}
+
+void NetplayState::draw()
+{
+	mWorld.draw();
+
+	sf::RenderWindow& window = *getContext().window;
+	window.setView(window.getDefaultView());
+	window.draw(mScoreText);
+	window.draw(mStatisticsText);
+}
+
+bool NetplayState::update(sf::Time dt)
+{
+	mSession.addLocalActions(mLocalPlayer.getRealtimeActions());
+	mSession.update(dt);
+
+	mScoreText.setString("Score: " + toString(World::getScore()));
+	updateStatistics();
+
+	// Only end the game on a state both machines agree on
+	if (mSession.isConfirmed())
+	{
+		if (!mWorld.hasAlivePlayer())
+		{
+			getContext().player->setMissionStatus(Player::MissionFailure);
+			requestStackPop();
+			requestStackPush(States::GameOver);
+		}
+		else if (mWorld.hasPlayerReachedEnd())
+		{
+			getContext().player->setMissionStatus(Player::MissionSuccess);
+			requestStackPop();
+			requestStackPush(States::GameOver);
+		}
+	}
+
+	return true;
+}
+
+bool NetplayState::handleEvent(const sf::Event& event)
+{
+	// One-shot actions are collected until the next frame is simulated
+	mSession.addLocalActions(mLocalPlayer.getEventActions(event));
+
+	// The remote player can't be paused, escape leaves the match
+	if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
+	{
+		requestStateClear();
+		requestStackPush(States::Menu);
+	}
+
+	return true;
+}
+
+NetplayState::Settings NetplayState::loadSettings(const std::string& filename)
+{
+	Settings settings;
+
+	// Optional file of "key value" lines, missing entries keep their defaults
+	std::ifstream file(filename);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		std::string key;
+		stream >> key;
+
+		if (key == "player")
+			stream >> settings.player;
+		else if (key == "remote_address")
+			stream >> settings.remoteAddress;
+		else if (key == "port")
+			stream >> settings.port;
+		else if (key == "latency_ms")
+		{
+			int milliseconds = 0;
+			stream >> milliseconds;
+			settings.latency = sf::milliseconds(milliseconds);
+		}
+		else if (key == "loss_percent")
+		{
+			float percent = 0.f;
+			stream >> percent;
+			settings.loss = percent / 100.f;
+		}
+	}
+
+	settings.player = (settings.player == 2) ? 2 : 1;
+	return settings;
+}
+
+void NetplayState::updateStatistics()
+{
+	std::string text = "Frame: " + toString(mSession.getFrame())
+		+ "\nConfirmed: " + toString(mSession.getConfirmedFrame())
+		+ "\nRollbacks: " + toString(mSession.getRollbackCount())
+		+ "\nLast rollback: " + toString(mSession.getLastRollbackLength()) + " frames, "
+			+ toString(mSession.getLastRollbackTime().asMicroseconds() / 1000.f) + " ms"
+		+ "\nWorst rollback: " + toString(mSession.getMaxRollbackTime().asMicroseconds() / 1000.f) + " ms";
+
+	if (mSession.isStalled())
+		text += "\nWaiting for the other player...";
+
+	if (mSession.isDesynced())
+		text += "\nDESYNC";
+
+	mStatisticsText.setString(text);
+}
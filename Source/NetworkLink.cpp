@@ -0,0 +1,76 @@
+#include "NetworkLink.hpp"
+
+
+NetworkLink::NetworkLink()
+: mSocket()
+, mRemoteAddress(sf::IpAddress::LocalHost)
+, mRemotePort(0)
+, mClock()
+, mLatency(sf::Time::Zero)
+, mLoss(0.f)
+, mOutgoing()
+, mLossEngine(std::random_device()())
+{
+	mSocket.setBlocking(false);
+}
+
+bool NetworkLink::bind(unsigned short localPort)
+{
+	return mSocket.bind(localPort) == sf::Socket::Done;
+}
+
+void NetworkLink::setRemote(const sf::IpAddress& address, unsigned short port)
+{
+	mRemoteAddress = address;
+	mRemotePort = port;
+}
+
+void NetworkLink::setSimulatedLatency(sf::Time latency)
+{
+	mLatency = latency;
+}
+
+void NetworkLink::setSimulatedLoss(float probability)
+{
+	mLoss = probability;
+}
+
+void NetworkLink::send(const sf::Packet& packet)
+{
+	// Dropped packets never make it to the socket; uses its own generator to leave the game's untouched
+	std::uniform_real_distribution<float> distribution(0.f, 1.f);
+	if (distribution(mLossEngine) < mLoss)
+		return;
+
+	PendingPacket pending;
+	pending.sendTime = mClock.getElapsedTime() + mLatency;
+	pending.packet = packet;
+	mOutgoing.push_back(pending);
+
+	update();
+}
+
+bool NetworkLink::receive(sf::Packet& packet)
+{
+	sf::IpAddress sender;
+	unsigned short port;
+
+	// Ignore datagrams from anyone but the peer; a link without remote port only listens, to anyone
+	while (mSocket.receive(packet, sender, port) == sf::Socket::Done)
+	{
+		if (mRemotePort == 0 || (sender == mRemoteAddress && port == mRemotePort))
+			return true;
+	}
+
+	return false;
+}
+
+void NetworkLink::update()
+{
+	// Send all packets whose simulated delay is over
+	while (!mOutgoing.empty() && mOutgoing.front().sendTime <= mClock.getElapsedTime())
+	{
+		mSocket.send(mOutgoing.front().packet, mRemoteAddress, mRemotePort);
+		mOutgoing.pop_front();
+	}
+}
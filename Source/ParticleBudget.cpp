@@ -0,0 +1,81 @@
+#include "ParticleBudget.hpp"
+#include "DataTables.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace
+{
+	const std::vector<ParticleData> Table = initializeParticleData();
+
+	// Update and draw together should stay within this, the rest of a 60 Hz frame is headroom
+	const sf::Time FrameBudget = sf::seconds(0.75f / 60.f);
+
+	// Quality drops quickly when frames are too slow, and recovers slowly once they are fast enough again
+	const float MinQuality = 0.25f;
+	const float QualityDecrease = 0.1f;
+	const float QualityIncrease = 0.02f;
+	const float RecoveryRatio = 0.75f;
+
+	// Emitters further away from the view than this don't emit at all
+	const float PriorityDistance = 512.f;
+
+	// Share of the budget that is left to emitters at the lowest priority, the rest is reserved for closer ones
+	const float MinBudgetShare = 0.5f;
+
+	// Approaching its limit, an emitter slows down over this share of the budget instead of stopping abruptly
+	const float TaperShare = 0.25f;
+}
+
+ParticleBudget::ParticleBudget()
+: mViewBounds()
+, mQuality(1.f)
+{
+	// A budget beyond the ring buffer's capacity would never throttle, the ring would overwrite particles first
+	for (std::size_t i = 0; i < Table.size(); ++i)
+		assert(Table[i].budget <= Table[i].capacity);
+}
+
+void ParticleBudget::setViewBounds(const sf::FloatRect& bounds)
+{
+	mViewBounds = bounds;
+}
+
+void ParticleBudget::setFrameTime(sf::Time frameTime)
+{
+	if (frameTime > FrameBudget)
+		mQuality = std::max(mQuality - QualityDecrease, MinQuality);
+	else if (frameTime < FrameBudget * RecoveryRatio)
+		mQuality = std::min(mQuality + QualityIncrease, 1.f);
+}
+
+float ParticleBudget::getEmissionRate(Particle::Type type, sf::Vector2f position, std::size_t particleCount) const
+{
+	const ParticleData& data = Table[type];
+
+	float priority = getPriority(position);
+	if (priority <= 0.f)
+		return 0.f;
+
+	// Lower priorities reach their limit earlier, which keeps room for the emitters in view
+	float limit = static_cast<float>(data.budget) * (MinBudgetShare + (1.f - MinBudgetShare) * priority);
+	float headroom = (limit - static_cast<float>(particleCount)) / (static_cast<float>(data.budget) * TaperShare);
+
+	return data.emissionRate * mQuality * std::min(std::max(headroom, 0.f), 1.f);
+}
+
+float ParticleBudget::getQuality() const
+{
+	return mQuality;
+}
+
+float ParticleBudget::getPriority(sf::Vector2f position) const
+{
+	// Full priority inside the view, falling off linearly with the distance to it
+	float dx = std::max(std::max(mViewBounds.left - position.x, position.x - (mViewBounds.left + mViewBounds.width)), 0.f);
+	float dy = std::max(std::max(mViewBounds.top - position.y, position.y - (mViewBounds.top + mViewBounds.height)), 0.f);
+
+	return 1.f - std::sqrt(dx * dx + dy * dy) / PriorityDistance;
+}
@@ -0,0 +1,173 @@
+#include "ParticleBuffer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PARTICLEBUFFER_SSE2
+	#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	// Slows count particles down by the damping factor, moves them and ages them by the given seconds
+	void advance(float* positionX, float* positionY, float* velocityX, float* velocityY, float* lifetime,
+		std::size_t count, float seconds, float damping)
+	{
+		std::size_t i = 0;
+
+#ifdef PARTICLEBUFFER_SSE2
+		__m128 time = _mm_set1_ps(seconds);
+		__m128 factor = _mm_set1_ps(damping);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 vx = _mm_mul_ps(_mm_loadu_ps(velocityX + i), factor);
+			__m128 vy = _mm_mul_ps(_mm_loadu_ps(velocityY + i), factor);
+			_mm_storeu_ps(velocityX + i, vx);
+			_mm_storeu_ps(velocityY + i, vy);
+			_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, time)));
+			_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, time)));
+			_mm_storeu_ps(lifetime + i, _mm_sub_ps(_mm_loadu_ps(lifetime + i), time));
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			velocityX[i] *= damping;
+			velocityY[i] *= damping;
+			positionX[i] += velocityX[i] * seconds;
+			positionY[i] += velocityY[i] * seconds;
+			lifetime[i] -= seconds;
+		}
+	}
+}
+
+ParticleBuffer::ParticleBuffer(std::size_t capacity)
+: mPositionX(capacity)
+, mPositionY(capacity)
+, mVelocityX(capacity)
+, mVelocityY(capacity)
+, mLifetime(capacity)
+, mHead(0)
+, mSize(0)
+, mAddedCount(0)
+, mLastMoving(0)
+{
+	assert(capacity > 0);
+}
+
+void ParticleBuffer::add(sf::Vector2f position, sf::Vector2f velocity, float lifetime)
+{
+	// Full: the oldest particle makes room
+	if (mSize == getCapacity())
+	{
+		mHead = getSlot(1);
+		--mSize;
+	}
+
+	// Remember the newest particle that moves, until it expires the positions change every update
+	++mAddedCount;
+	if (velocity != sf::Vector2f())
+		mLastMoving = mAddedCount;
+
+	std::size_t slot = getSlot(mSize++);
+	mPositionX[slot] = position.x;
+	mPositionY[slot] = position.y;
+	mVelocityX[slot] = velocity.x;
+	mVelocityY[slot] = velocity.y;
+	mLifetime[slot] = lifetime;
+}
+
+void ParticleBuffer::update(float seconds, float drag)
+{
+	integrate(0, mSize, seconds, drag);
+	removeExpired();
+}
+
+void ParticleBuffer::integrate(std::size_t begin, std::size_t end, float seconds, float drag)
+{
+	// A range of particles is at most two contiguous runs of slots: up to the end of the arrays, and wrapped around
+	float damping = std::exp(-drag * seconds);
+	while (begin < end)
+	{
+		std::size_t slot = getSlot(begin);
+		std::size_t run = std::min(end - begin, getCapacity() - slot);
+
+		advance(&mPositionX[slot], &mPositionY[slot], &mVelocityX[slot], &mVelocityY[slot], &mLifetime[slot],
+			run, seconds, damping);
+		begin += run;
+	}
+}
+
+void ParticleBuffer::removeExpired()
+{
+	// Lifetimes grow from the oldest particle to the newest, so the expired ones are found by bisection
+	std::size_t low = 0;
+	std::size_t high = mSize;
+	while (low < high)
+	{
+		std::size_t middle = low + (high - low) / 2;
+		if (mLifetime[getSlot(middle)] <= 0.f)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	mHead = getSlot(low);
+	mSize -= low;
+}
+
+void ParticleBuffer::translate(sf::Vector2f offset)
+{
+	for (std::size_t i = 0; i < mSize; ++i)
+	{
+		std::size_t slot = getSlot(i);
+		mPositionX[slot] += offset.x;
+		mPositionY[slot] += offset.y;
+	}
+}
+
+void ParticleBuffer::clear()
+{
+	mHead = 0;
+	mSize = 0;
+}
+
+std::size_t ParticleBuffer::getSize() const
+{
+	return mSize;
+}
+
+std::size_t ParticleBuffer::getCapacity() const
+{
+	return mLifetime.size();
+}
+
+sf::Uint64 ParticleBuffer::getAddedCount() const
+{
+	return mAddedCount;
+}
+
+bool ParticleBuffer::hasMovingParticles() const
+{
+	return mLastMoving > mAddedCount - mSize;
+}
+
+std::size_t ParticleBuffer::getSlot(std::size_t index) const
+{
+	std::size_t slot = mHead + index;
+	return (slot >= getCapacity()) ? slot - getCapacity() : slot;
+}
+
+sf::Vector2f ParticleBuffer::getPosition(std::size_t index) const
+{
+	std::size_t slot = getSlot(index);
+	return sf::Vector2f(mPositionX[slot], mPositionY[slot]);
+}
+
+float ParticleBuffer::getLifetime(std::size_t index) const
+{
+	return mLifetime[getSlot(index)];
+}
@@ -1,10 +1,10 @@
 #include "ParticleNode.hpp"
-#include "Foreach.hpp"
 #include "DataTables.hpp"
 #include "ResourceHolder.hpp"
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/OpenGL.hpp>
 
 #include <algorithm>
 
@@ -12,26 +12,47 @@
 namespace
 {
 	const std::vector<ParticleData> Table = initializeParticleData();
+
+	// Birth timestamps are whole milliseconds, wrapped to the 24 bits the vertex colour can hold
+	const sf::Int32 TimestampMask = 0xffffff;
+
+	// Fewest particles worth handing to another thread, smaller systems are processed serially
+	const std::size_t MinChunkSize = 4096;
+
+	// Missing from the OpenGL 1.1 headers some platforms ship
+#ifndef GL_VERTEX_PROGRAM_POINT_SIZE
+	const GLenum GL_VERTEX_PROGRAM_POINT_SIZE = 0x8642;
+#endif
+#ifndef GL_POINT_SPRITE
+	const GLenum GL_POINT_SPRITE = 0x8861;
+#endif
 }
 
-ParticleNode::ParticleNode(Particle::Type type, const TextureHolder& textures)
+ParticleNode::ParticleNode(Particle::Type type, const TextureHolder& textures, ShaderHolder& shaders, WorkerPool& workers,
+	const ParticleBudget& budget)
 : SceneNode()
-, mParticles()
+, mParticles(Table[type].capacity)
 , mTexture(textures.get(Textures::Particle))
+, mShader(sf::Shader::isAvailable() ? &shaders.get(Shaders::ParticlePass) : nullptr)
+, mWorkers(workers)
+, mBudget(budget)
 , mType(type)
-, mVertexArray(sf::Quads)
+, mElapsedTime(sf::Time::Zero)
+, mVertices(mParticles.getCapacity() * getVerticesPerParticle())
+, mWrittenCount(0)
 , mNeedsVertexUpdate(true)
+, mNeedsFullUpdate(true)
 {
 }
 
-void ParticleNode::addParticle(sf::Vector2f position)
+void ParticleNode::addParticle(sf::Vector2f position, sf::Vector2f velocity)
 {
-	Particle particle;
-	particle.position = position;
-	particle.color = Table[mType].color;
-	particle.lifetime = Table[mType].lifetime;
+	mParticles.add(position, velocity, Table[mType].lifetime.asSeconds());
+}
 
-	mParticles.push_back(particle);
+float ParticleNode::getEmissionRate(sf::Vector2f position) const
+{
+	return mBudget.getEmissionRate(mType, position, mParticles.getSize());
 }
 
 Particle::Type ParticleNode::getParticleType() const
@@ -39,67 +60,164 @@ Particle::Type ParticleNode::getParticleType() const
 	return mType;
 }
 
+std::size_t ParticleNode::getParticleCount() const
+{
+	return mParticles.getSize();
+}
+
 unsigned int ParticleNode::getCategory() const
 {
 	return Category::ParticleSystem;	
 }
 
+void ParticleNode::translateOrigin(sf::Vector2f offset)
+{
+	// Particles are stored in world coordinates, the node itself stays at the origin
+	mParticles.translate(offset);
+
+	mNeedsVertexUpdate = true;
+	mNeedsFullUpdate = true;
+}
+
 void ParticleNode::updateCurrent(sf::Time dt, CommandQueue&)
 {
-	// Remove expired particles at beginning
-	while (!mParticles.empty() && mParticles.front().lifetime <= sf::Time::Zero)
-		mParticles.pop_front();
+	// Move, slow down and age all particles in parallel chunks, then drop the expired ones
+	float seconds = dt.asSeconds();
+	float drag = Table[mType].drag;
+	mWorkers.run(mParticles.getSize(), MinChunkSize, [this, seconds, drag] (std::size_t begin, std::size_t end)
+	{
+		mParticles.integrate(begin, end, seconds, drag);
+	});
 
-	// Decrease lifetime of existing particles
-	FOREACH(Particle& particle, mParticles)
-		particle.lifetime -= dt;
+	mParticles.removeExpired();
+	mElapsedTime += dt;
 
 	mNeedsVertexUpdate = true;
 }
 
 void ParticleNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
 {
+	// Apply particle texture
+	states.texture = &mTexture;
+
 	if (mNeedsVertexUpdate)
 	{
-		computeVertices();
+		updateVertices();
 		mNeedsVertexUpdate = false;
 	}
 
-	// Apply particle texture
-	states.texture = &mTexture;
-	
-	// Draw vertices
-	target.draw(mVertexArray, states);
+	if (mShader)
+	{
+		// Point sizes are in pixels, so the texture size is scaled like the view scales the world
+		const sf::View& view = target.getView();
+		float pixelsPerUnit = static_cast<float>(target.getViewport(view).width) / view.getSize().x;
+
+		mShader->setParameter("texture", sf::Shader::CurrentTexture);
+		mShader->setParameter("color", Table[mType].color);
+		mShader->setParameter("lifetime", static_cast<float>(Table[mType].lifetime.asMilliseconds()));
+		mShader->setParameter("time", static_cast<float>(mElapsedTime.asMilliseconds() & TimestampMask));
+		mShader->setParameter("size", static_cast<float>(mTexture.getSize().x) * pixelsPerUnit);
+		states.shader = mShader;
+	}
+
+	// The live particles are one run of slots in the ring, or two when it wraps around
+	std::size_t stride = getVerticesPerParticle();
+	sf::PrimitiveType primitive = mShader ? sf::Points : sf::Quads;
+	std::size_t head = mParticles.getSlot(0);
+	std::size_t first = std::min(mParticles.getSize(), mParticles.getCapacity() - head);
+
+	if (mShader)
+	{
+		// SFML leaves these off, the vertex shader sets the size and the fragment shader samples across the sprite.
+		// Pushing the states activates the target's context, popping them switches both off again
+		target.pushGLStates();
+		glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+		glEnable(GL_POINT_SPRITE);
+	}
+
+	if (first > 0)
+		target.draw(&mVertices[head * stride], first * stride, primitive, states);
+	if (mParticles.getSize() > first)
+		target.draw(&mVertices[0], (mParticles.getSize() - first) * stride, primitive, states);
+
+	// The pop also undoes the texture and shader the draws bound, which SFML still remembers as current
+	if (mShader)
+	{
+		target.popGLStates();
+		target.resetGLStates();
+	}
 }
 
-void ParticleNode::addVertex(float worldX, float worldY, float texCoordX, float texCoordY, const sf::Color& color) const
+void ParticleNode::writePoint(std::size_t index, sf::Vertex& point) const
 {
-	sf::Vertex vertex;
-	vertex.position = sf::Vector2f(worldX, worldY);
-	vertex.texCoords = sf::Vector2f(texCoordX, texCoordY);
-	vertex.color = color;
+	// The shader expands the point and fades it by itself, the colour bytes carry the time it was born
+	float lifetime = Table[mType].lifetime.asSeconds();
+	sf::Int32 age = static_cast<sf::Int32>((lifetime - mParticles.getLifetime(index)) * 1000.f);
+	sf::Int32 birth = (mElapsedTime.asMilliseconds() - age) & TimestampMask;
 
-	mVertexArray.append(vertex);
+	point.position = mParticles.getPosition(index);
+	point.color = sf::Color(static_cast<sf::Uint8>(birth >> 16), static_cast<sf::Uint8>(birth >> 8), static_cast<sf::Uint8>(birth), 255);
 }
 
-void ParticleNode::computeVertices() const
+void ParticleNode::writeQuad(std::size_t index, sf::Vertex* quad) const
 {
 	sf::Vector2f size(mTexture.getSize());
 	sf::Vector2f half = size / 2.f;
+	sf::Vector2f pos = mParticles.getPosition(index);
+	sf::Color color = Table[mType].color;
+
+	float ratio = mParticles.getLifetime(index) / Table[mType].lifetime.asSeconds();
+	color.a = static_cast<sf::Uint8>(255 * std::max(ratio, 0.f));
 
-	// Refill vertex array
-	mVertexArray.clear();
-	FOREACH(const Particle& particle, mParticles)
+	quad[0] = sf::Vertex(sf::Vector2f(pos.x - half.x, pos.y - half.y), color, sf::Vector2f(0.f,    0.f));
+	quad[1] = sf::Vertex(sf::Vector2f(pos.x + half.x, pos.y - half.y), color, sf::Vector2f(size.x, 0.f));
+	quad[2] = sf::Vertex(sf::Vector2f(pos.x + half.x, pos.y + half.y), color, sf::Vector2f(size.x, size.y));
+	quad[3] = sf::Vertex(sf::Vector2f(pos.x - half.x, pos.y + half.y), color, sf::Vector2f(0.f,    size.y));
+}
+
+void ParticleNode::writeVertices(std::size_t begin, std::size_t end, sf::Vertex* vertices) const
+{
+	// Every chunk writes its own slice of the vertices
+	mWorkers.run(end - begin, MinChunkSize, [this, begin, vertices] (std::size_t first, std::size_t last)
 	{
-		sf::Vector2f pos = particle.position;
-		sf::Color color = particle.color;
+		if (mShader)
+		{
+			for (std::size_t i = first; i < last; ++i)
+				writePoint(begin + i, vertices[i]);
+		}
+		else
+		{
+			for (std::size_t i = first; i < last; ++i)
+				writeQuad(begin + i, vertices + i * 4);
+		}
+	});
+}
 
-		float ratio = particle.lifetime.asSeconds() / Table[mType].lifetime.asSeconds();
-		color.a = static_cast<sf::Uint8>(255 * std::max(ratio, 0.f));
+std::size_t ParticleNode::getVerticesPerParticle() const
+{
+	return mShader ? 1 : 4;
+}
+
+void ParticleNode::updateVertices() const
+{
+	// Only the particles added since the last update are written: the shader fades them, expired ones are simply
+	// not drawn any more. Without the shader the fade, and for moving particles the positions, change every frame
+	std::size_t size = mParticles.getSize();
+	std::size_t count = static_cast<std::size_t>(std::min<sf::Uint64>(mParticles.getAddedCount() - mWrittenCount, size));
+	if (!mShader || mNeedsFullUpdate || mParticles.hasMovingParticles())
+		count = size;
+
+	mWrittenCount = mParticles.getAddedCount();
+	mNeedsFullUpdate = false;
+
+	// The range covers at most two runs of slots, each one is written in place
+	std::size_t stride = getVerticesPerParticle();
+	for (std::size_t i = 0; i < count; )
+	{
+		std::size_t slot = mParticles.getSlot(size - count + i);
+		std::size_t run = std::min(count - i, mParticles.getCapacity() - slot);
 
-		addVertex(pos.x - half.x, pos.y - half.y, 0.f,    0.f,    color);
-		addVertex(pos.x + half.x, pos.y - half.y, size.x, 0.f,    color);
-		addVertex(pos.x + half.x, pos.y + half.y, size.x, size.y, color);
-		addVertex(pos.x - half.x, pos.y + half.y, 0.f,    size.y, color);
+		writeVertices(size - count + i, size - count + i + run, &mVertices[slot * stride]);
+		i += run;
 	}
 }
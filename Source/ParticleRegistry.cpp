@@ -0,0 +1,31 @@
+#include "ParticleRegistry.hpp"
+#include "ParticleNode.hpp"
+#include "TrailNode.hpp"
+
+
+ParticleRegistry::ParticleRegistry()
+: mSystems()
+, mTrails(nullptr)
+{
+	mSystems.fill(nullptr);
+}
+
+void ParticleRegistry::add(ParticleNode& system)
+{
+	mSystems[system.getParticleType()] = &system;
+}
+
+ParticleNode* ParticleRegistry::get(Particle::Type type) const
+{
+	return mSystems[type];
+}
+
+void ParticleRegistry::setTrails(TrailNode& trails)
+{
+	mTrails = &trails;
+}
+
+TrailNode* ParticleRegistry::getTrails() const
+{
+	return mTrails;
+}
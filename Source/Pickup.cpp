@@ -1,9 +1,11 @@
 #include "Pickup.hpp"
+#include "SpriteBatch.hpp"
 #include "DataTables.hpp"
 #include "Category.hpp"
 #include "CommandQueue.hpp"
 #include "Utility.hpp"
 #include "ResourceHolder.hpp"
+#include "Snapshot.hpp"
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -41,3 +43,16 @@ void Pickup::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) cons
 	target.draw(mSprite, states);
 }
 
+bool Pickup::batchCurrent(SpriteBatch& batch, const sf::Transform& transform) const
+{
+	batch.draw(mSprite, transform);
+	return true;
+}
+
+void Pickup::saveState(EntityState& state) const
+{
+	Entity::saveState(state);
+
+	state.kind = EntityState::PickupEntity;
+	state.type = static_cast<sf::Uint8>(mType);
+}
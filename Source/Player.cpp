@@ -12,21 +12,57 @@ using namespace std::placeholders;
 
 struct AircraftMover
 {
-	AircraftMover(float vx, float vy)
+	AircraftMover(float vx, float vy, int identifier)
 	: velocity(vx, vy)
+	, aircraftID(identifier)
 	{
 	}
 
 	void operator() (Aircraft& aircraft, sf::Time) const
 	{
-		aircraft.accelerate(velocity * aircraft.getMaxSpeed());
+		if (aircraft.getIdentifier() == aircraftID)
+			aircraft.accelerate(velocity * aircraft.getMaxSpeed());
 	}
 
 	sf::Vector2f velocity;
+	int aircraftID;
 };
 
-Player::Player()
+struct AircraftFireTrigger
+{
+	explicit AircraftFireTrigger(int identifier)
+	: aircraftID(identifier)
+	{
+	}
+
+	void operator() (Aircraft& aircraft, sf::Time) const
+	{
+		if (aircraft.getIdentifier() == aircraftID)
+			aircraft.fire();
+	}
+
+	int aircraftID;
+};
+
+struct AircraftMissileTrigger
+{
+	explicit AircraftMissileTrigger(int identifier)
+	: aircraftID(identifier)
+	{
+	}
+
+	void operator() (Aircraft& aircraft, sf::Time) const
+	{
+		if (aircraft.getIdentifier() == aircraftID)
+			aircraft.launchMissile();
+	}
+
+	int aircraftID;
+};
+
+Player::Player(int identifier)
 : mCurrentMissionStatus(MissionRunning)
+, mIdentifier(identifier)
 {
 	// Set initial key bindings
 	mKeyBinding[sf::Keyboard::Left] = MoveLeft;
@@ -46,26 +82,58 @@ Player::Player()
 
 void Player::handleEvent(const sf::Event& event, CommandQueue& commands)
 {
+	applyActions(getEventActions(event), commands);
+}
+
+void Player::handleRealtimeInput(CommandQueue& commands)
+{
+	applyActions(getRealtimeActions(), commands);
+}
+
+Player::ActionSet Player::getEventActions(const sf::Event& event) const
+{
+	ActionSet actions = 0;
+
 	if (event.type == sf::Event::KeyPressed)
 	{
-		// Check if pressed key appears in key binding, trigger command if so
+		// Check if pressed key appears in key binding
 		auto found = mKeyBinding.find(event.key.code);
 		if (found != mKeyBinding.end() && !isRealtimeAction(found->second))
-			commands.push(mActionBinding[found->second]);
+			actions |= 1 << found->second;
 	}
+
+	return actions;
 }
 
-void Player::handleRealtimeInput(CommandQueue& commands)
+Player::ActionSet Player::getRealtimeActions() const
 {
+	ActionSet actions = 0;
+
 	// Traverse all assigned keys and check if they are pressed
 	FOREACH(auto pair, mKeyBinding)
 	{
-		// If key is pressed, lookup action and trigger corresponding command
 		if (sf::Keyboard::isKeyPressed(pair.first) && isRealtimeAction(pair.second))
-			commands.push(mActionBinding[pair.second]);
+			actions |= 1 << pair.second;
+	}
+
+	return actions;
+}
+
+void Player::applyActions(ActionSet actions, CommandQueue& commands)
+{
+	// Trigger the command of every action in the set, in a fixed order
+	for (int action = 0; action < ActionCount; ++action)
+	{
+		if (actions & (1 << action))
+			commands.push(mActionBinding[static_cast<Action>(action)]);
 	}
 }
 
+int Player::getIdentifier() const
+{
+	return mIdentifier;
+}
+
 void Player::assignKey(Action action, sf::Keyboard::Key key)
 {
 	// Remove all keys that already map to action
@@ -104,12 +172,12 @@ Player::MissionStatus Player::getMissionStatus() const
 
 void Player::initializeActions()
 {
-	mActionBinding[MoveLeft].action      = derivedAction<Aircraft>(AircraftMover(-1,  0));
-	mActionBinding[MoveRight].action     = derivedAction<Aircraft>(AircraftMover(+1,  0));
-	mActionBinding[MoveUp].action        = derivedAction<Aircraft>(AircraftMover( 0, -1));
-	mActionBinding[MoveDown].action      = derivedAction<Aircraft>(AircraftMover( 0, +1));
-	mActionBinding[Fire].action          = derivedAction<Aircraft>([] (Aircraft& a, sf::Time) { a.fire(); });
-	mActionBinding[LaunchMissile].action = derivedAction<Aircraft>([] (Aircraft& a, sf::Time) { a.launchMissile(); });
+	mActionBinding[MoveLeft].action      = derivedAction<Aircraft>(AircraftMover(-1,  0, mIdentifier));
+	mActionBinding[MoveRight].action     = derivedAction<Aircraft>(AircraftMover(+1,  0, mIdentifier));
+	mActionBinding[MoveUp].action        = derivedAction<Aircraft>(AircraftMover( 0, -1, mIdentifier));
+	mActionBinding[MoveDown].action      = derivedAction<Aircraft>(AircraftMover( 0, +1, mIdentifier));
+	mActionBinding[Fire].action          = derivedAction<Aircraft>(AircraftFireTrigger(mIdentifier));
+	mActionBinding[LaunchMissile].action = derivedAction<Aircraft>(AircraftMissileTrigger(mIdentifier));
 }
 
 bool Player::isRealtimeAction(Action action)
@@ -1,8 +1,9 @@
 #include "Projectile.hpp"
-#include "EmitterNode.hpp"
+#include "SpriteBatch.hpp"
 #include "DataTables.hpp"
 #include "Utility.hpp"
 #include "ResourceHolder.hpp"
+#include "Snapshot.hpp"
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
@@ -16,26 +17,15 @@ namespace
 	const std::vector<ProjectileData> Table = initializeProjectileData();
 }
 
-Projectile::Projectile(Type type, const TextureHolder& textures)
+Projectile::Projectile(Type type, const TextureHolder& textures, ParticleRegistry& particles)
 : Entity(1)
 , mType(type)
 , mSprite(textures.get(Table[type].texture), Table[type].textureRect)
 , mTargetDirection()
+, mTrails(isGuided() ? particles.getTrails() : nullptr)
+, mTrail(mTrails ? mTrails->addTrail() : TrailNode::InvalidID)
 {
 	centerOrigin(mSprite);
-
-	// Add particle system for missiles
-	if (isGuided())
-	{
-		std::unique_ptr<EmitterNode> smoke(new EmitterNode(Particle::Smoke));
-		smoke->setPosition(0.f, getBoundingRect().height / 2.f);
-		attachChild(std::move(smoke));
-
-		std::unique_ptr<EmitterNode> propellant(new EmitterNode(Particle::Propellant));
-		propellant->setPosition(0.f, getBoundingRect().height / 2.f);
-		attachChild(std::move(propellant));
-
-	}
 }
 
 void Projectile::guideTowards(sf::Vector2f position)
@@ -64,6 +54,13 @@ void Projectile::updateCurrent(sf::Time dt, CommandQueue& commands)
 	}
 
 	Entity::updateCurrent(dt, commands);
+
+	// Missiles leave a smoke trail from their tail, it fades out by itself once the missile is gone
+	if (mTrails)
+	{
+		mTrails->extendTrail(mTrail, getTransform().transformPoint(0.f, mSprite.getLocalBounds().height / 2.f));
+		assert(mTrails->getPointCount(mTrail) > 0);
+	}
 }
 
 void Projectile::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
@@ -71,6 +68,12 @@ void Projectile::drawCurrent(sf::RenderTarget& target, sf::RenderStates states)
 	target.draw(mSprite, states);
 }
 
+bool Projectile::batchCurrent(SpriteBatch& batch, const sf::Transform& transform) const
+{
+	batch.draw(mSprite, transform);
+	return true;
+}
+
 unsigned int Projectile::getCategory() const
 {
 	if (mType == EnemyBullet)
@@ -93,3 +96,19 @@ int Projectile::getDamage() const
 {
 	return Table[mType].damage;
 }
+
+void Projectile::saveState(EntityState& state) const
+{
+	Entity::saveState(state);
+
+	state.kind = EntityState::ProjectileEntity;
+	state.type = static_cast<sf::Uint8>(mType);
+	state.targetDirection = mTargetDirection;
+}
+
+void Projectile::loadState(const EntityState& state)
+{
+	Entity::loadState(state);
+
+	mTargetDirection = state.targetDirection;
+}
@@ -0,0 +1,286 @@
+#include "RollbackSession.hpp"
+#include "World.hpp"
+#include "NetworkLink.hpp"
+#include "SoundPlayer.hpp"
+
+#include <SFML/Network/Packet.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
+
+
+RollbackSession::FrameChecksum::FrameChecksum()
+: frame(-1)
+, checksum(0)
+{
+}
+
+RollbackSession::RollbackSession(World& world, Player& localPlayer, Player& remotePlayer, NetworkLink& link, SoundPlayer& sounds)
+: mWorld(world)
+, mLocalPlayer(localPlayer)
+, mRemotePlayer(remotePlayer)
+, mLink(link)
+, mSounds(sounds)
+, mFrame(0)
+, mConfirmedFrame(-1)
+, mRemoteAckFrame(-1)
+, mPendingActions(0)
+, mRealtimeMask(0)
+, mStalled(false)
+, mLocalInputs()
+, mRemoteInputs()
+, mSnapshots()
+, mLocalChecksums()
+, mRemoteChecksums()
+, mLastChecksumFrame(-1)
+, mDesynced(false)
+, mRollbackCount(0)
+, mLastRollbackLength(0)
+, mLastRollbackTime(sf::Time::Zero)
+, mMaxRollbackTime(sf::Time::Zero)
+{
+	// Only held actions are predicted to continue, one-shot ones like missiles are not
+	for (int action = 0; action < Player::ActionCount; ++action)
+	{
+		if (Player::isRealtimeAction(static_cast<Player::Action>(action)))
+			mRealtimeMask |= 1 << action;
+	}
+}
+
+void RollbackSession::addLocalActions(Player::ActionSet actions)
+{
+	mPendingActions |= actions;
+}
+
+void RollbackSession::update(sf::Time dt)
+{
+	mLink.update();
+
+	// Correct the past if the remote player did something else than predicted
+	sf::Int32 mispredictedFrame = receiveInputs();
+	if (mispredictedFrame < mFrame)
+		rollback(mispredictedFrame, dt);
+
+	recordChecksums();
+
+	// Never run further ahead of the remote player than a rollback can repair
+	mStalled = mFrame - mConfirmedFrame > MaxRollbackFrames;
+	if (!mStalled)
+	{
+		mLocalInputs[mFrame % InputBufferSize] = mPendingActions;
+		mPendingActions = 0;
+
+		// When the remote player is ahead, the frame's actual input has arrived already
+		if (mFrame > mConfirmedFrame)
+			mRemoteInputs[mFrame % InputBufferSize] = predictRemoteActions();
+
+		simulate(mFrame, dt);
+		++mFrame;
+	}
+
+	sendInputs();
+}
+
+sf::Int32 RollbackSession::getFrame() const
+{
+	return mFrame;
+}
+
+sf::Int32 RollbackSession::getConfirmedFrame() const
+{
+	return mConfirmedFrame;
+}
+
+bool RollbackSession::isConfirmed() const
+{
+	// All frames simulated so far used the actual remote inputs
+	return mConfirmedFrame + 1 >= mFrame;
+}
+
+bool RollbackSession::isStalled() const
+{
+	return mStalled;
+}
+
+bool RollbackSession::isDesynced() const
+{
+	return mDesynced;
+}
+
+std::size_t RollbackSession::getRollbackCount() const
+{
+	return mRollbackCount;
+}
+
+sf::Int32 RollbackSession::getLastRollbackLength() const
+{
+	return mLastRollbackLength;
+}
+
+sf::Time RollbackSession::getLastRollbackTime() const
+{
+	return mLastRollbackTime;
+}
+
+sf::Time RollbackSession::getMaxRollbackTime() const
+{
+	return mMaxRollbackTime;
+}
+
+sf::Int32 RollbackSession::receiveInputs()
+{
+	sf::Int32 mispredictedFrame = mFrame;
+
+	sf::Packet packet;
+	while (mLink.receive(packet))
+	{
+		sf::Int32 ackFrame, checksumFrame, firstFrame;
+		sf::Uint32 checksum;
+		sf::Uint8 count;
+
+		if (!(packet >> ackFrame >> checksumFrame >> checksum >> firstFrame >> count))
+			continue;
+
+		mRemoteAckFrame = std::max(mRemoteAckFrame, ackFrame);
+
+		if (checksumFrame >= 0)
+		{
+			FrameChecksum& remote = mRemoteChecksums[checksumFrame % InputBufferSize];
+			remote.frame = checksumFrame;
+			remote.checksum = checksum;
+			compareChecksum(checksumFrame);
+		}
+
+		for (sf::Int32 frame = firstFrame; frame < firstFrame + count; ++frame)
+		{
+			Player::ActionSet actions;
+			if (!(packet >> actions))
+				break;
+
+			// Inputs are confirmed without gaps; older ones are known, newer ones are sent again
+			if (frame != mConfirmedFrame + 1 || frame >= mFrame + InputBufferSize - MaxRollbackFrames)
+				continue;
+
+			Player::ActionSet& predicted = mRemoteInputs[frame % InputBufferSize];
+			if (frame < mFrame && predicted != actions)
+				mispredictedFrame = std::min(mispredictedFrame, frame);
+
+			predicted = actions;
+			mConfirmedFrame = frame;
+		}
+	}
+
+	// The newest confirmed input may change the prediction of the frames after it
+	Player::ActionSet prediction = predictRemoteActions();
+	for (sf::Int32 frame = mConfirmedFrame + 1; frame < mFrame; ++frame)
+	{
+		Player::ActionSet& predicted = mRemoteInputs[frame % InputBufferSize];
+		if (predicted != prediction)
+		{
+			mispredictedFrame = std::min(mispredictedFrame, frame);
+			predicted = prediction;
+		}
+	}
+
+	return mispredictedFrame;
+}
+
+void RollbackSession::rollback(sf::Int32 frame, sf::Time dt)
+{
+	sf::Clock clock;
+
+	// The sounds of the replayed frames have been played already
+	mWorld.loadState(mSnapshots[frame % SnapshotCount]);
+	mSounds.setMuted(true);
+
+	for (sf::Int32 replayed = frame; replayed < mFrame; ++replayed)
+		simulate(replayed, dt);
+
+	mSounds.setMuted(false);
+
+	mLastRollbackLength = mFrame - frame;
+	mLastRollbackTime = clock.getElapsedTime();
+	mMaxRollbackTime = std::max(mMaxRollbackTime, mLastRollbackTime);
+	++mRollbackCount;
+}
+
+void RollbackSession::simulate(sf::Int32 frame, sf::Time dt)
+{
+	// Remember the state before the frame, in case it has to be simulated again
+	WorldSnapshot& snapshot = mSnapshots[frame % SnapshotCount];
+	mWorld.saveState(snapshot);
+	snapshot.frame = static_cast<sf::Uint32>(frame);
+
+	// Apply the actions in the order of the players' identifiers, the same on both machines
+	Player::ActionSet localActions = mLocalInputs[frame % InputBufferSize];
+	Player::ActionSet remoteActions = mRemoteInputs[frame % InputBufferSize];
+	CommandQueue& commands = mWorld.getCommandQueue();
+
+	if (mLocalPlayer.getIdentifier() < mRemotePlayer.getIdentifier())
+	{
+		mLocalPlayer.applyActions(localActions, commands);
+		mRemotePlayer.applyActions(remoteActions, commands);
+	}
+	else
+	{
+		mRemotePlayer.applyActions(remoteActions, commands);
+		mLocalPlayer.applyActions(localActions, commands);
+	}
+
+	mWorld.update(dt);
+}
+
+void RollbackSession::sendInputs()
+{
+	// Resend every input the remote player hasn't acknowledged yet, lost packets need no special care
+	sf::Int32 firstFrame = std::max(mRemoteAckFrame + 1, mFrame - static_cast<sf::Int32>(InputBufferSize) + 1);
+	firstFrame = std::max(firstFrame, mFrame - 255);
+	sf::Uint8 count = static_cast<sf::Uint8>(mFrame - firstFrame);
+
+	sf::Uint32 checksum = 0;
+	if (mLastChecksumFrame >= 0)
+		checksum = mLocalChecksums[mLastChecksumFrame % InputBufferSize].checksum;
+
+	sf::Packet packet;
+	packet << mConfirmedFrame << mLastChecksumFrame << checksum << firstFrame << count;
+
+	for (sf::Int32 frame = firstFrame; frame < mFrame; ++frame)
+		packet << mLocalInputs[frame % InputBufferSize];
+
+	mLink.send(packet);
+}
+
+Player::ActionSet RollbackSession::predictRemoteActions() const
+{
+	if (mConfirmedFrame < 0)
+		return 0;
+
+	return mRemoteInputs[mConfirmedFrame % InputBufferSize] & mRealtimeMask;
+}
+
+void RollbackSession::recordChecksums()
+{
+	// A snapshot is final once the inputs of all frames before it are confirmed
+	sf::Int32 lastFinalFrame = std::min(mConfirmedFrame + 1, mFrame - 1);
+	sf::Int32 frame = std::max(mLastChecksumFrame + 1, mFrame - static_cast<sf::Int32>(SnapshotCount) + 1);
+
+	for (; frame <= lastFinalFrame; ++frame)
+	{
+		FrameChecksum& local = mLocalChecksums[frame % InputBufferSize];
+		local.frame = frame;
+		local.checksum = computeChecksum(mSnapshots[frame % SnapshotCount]);
+
+		mLastChecksumFrame = frame;
+		compareChecksum(frame);
+	}
+}
+
+void RollbackSession::compareChecksum(sf::Int32 frame)
+{
+	const FrameChecksum& local = mLocalChecksums[frame % InputBufferSize];
+	const FrameChecksum& remote = mRemoteChecksums[frame % InputBufferSize];
+
+	// Only compare once both sides know the frame's checksum
+	if (local.frame == frame && remote.frame == frame && local.checksum != remote.checksum)
+		mDesynced = true;
+}
@@ -1,5 +1,6 @@
 #include "SceneNode.hpp"
 #include "Command.hpp"
+#include "SpriteBatch.hpp"
 #include "Foreach.hpp"
 #include "Utility.hpp"
 
@@ -11,6 +12,12 @@
 #include <cmath>
 
 
+namespace
+{
+	// Room around an entity's bounds for attached decorations such as health labels
+	const float CullMargin = 64.f;
+}
+
 SceneNode::SceneNode(Category::Type category)
 : mChildren()
 , mParent(nullptr)
@@ -35,6 +42,11 @@ SceneNode::Ptr SceneNode::detachChild(const SceneNode& node)
 	return result;
 }
 
+const std::vector<SceneNode::Ptr>& SceneNode::getChildren() const
+{
+	return mChildren;
+}
+
 void SceneNode::update(sf::Time dt, CommandQueue& commands)
 {
 	updateCurrent(dt, commands);
@@ -70,12 +82,119 @@ void SceneNode::drawCurrent(sf::RenderTarget&, sf::RenderStates) const
 	// Do nothing by default
 }
 
+bool SceneNode::batchCurrent(SpriteBatch&, const sf::Transform&) const
+{
+	// Drawn by drawCurrent() by default
+	return false;
+}
+
 void SceneNode::drawChildren(sf::RenderTarget& target, sf::RenderStates states) const
 {
 	FOREACH(const Ptr& child, mChildren)
 		child->draw(target, states);
 }
 
+void SceneNode::collectDrawLists(const std::vector<sf::FloatRect>& viewRects, std::vector<DrawList>& drawLists) const
+{
+	assert(viewRects.size() < sizeof(unsigned int) * 8);
+
+	drawLists.resize(viewRects.size());
+	FOREACH(DrawList& list, drawLists)
+		list.clear();
+
+	// A single traversal fills the lists of all views, in the same order draw() would visit the nodes
+	collectVisible(viewRects, drawLists, sf::Transform::Identity, (1u << viewRects.size()) - 1u, nullptr);
+}
+
+void SceneNode::drawList(const DrawList& list, sf::RenderTarget& target, SpriteBatch& batch, sf::RenderStates states)
+{
+	// Sprites are batched per layer, the batch is drawn when the layer ends. The other nodes of a layer keep
+	// their order among themselves: the ones before its first batched sprite are drawn below the whole batch,
+	// all later ones (like the texts of the aircraft) above the whole batch, including the sprites that come
+	// after them. A node that has to be drawn between sprites needs a layer of its own, like the explosions
+	DrawList above;
+	const SceneNode* layer = nullptr;
+	bool isBatching = false;
+
+	auto finishLayer = [&] ()
+	{
+		batch.flush(target, states);
+		isBatching = false;
+
+		FOREACH(const DrawCommand& command, above)
+		{
+			states.transform = command.transform;
+			command.node->drawCurrent(target, states);
+		}
+		above.clear();
+	};
+
+	FOREACH(const DrawCommand& command, list)
+	{
+		if (command.layer != layer)
+		{
+			finishLayer();
+			layer = command.layer;
+		}
+
+		if (command.node->batchCurrent(batch, command.transform))
+		{
+			isBatching = true;
+			continue;
+		}
+
+		if (isBatching)
+		{
+			above.push_back(command);
+		}
+		else
+		{
+			states.transform = command.transform;
+			command.node->drawCurrent(target, states);
+		}
+	}
+
+	finishLayer();
+}
+
+void SceneNode::collectVisible(const std::vector<sf::FloatRect>& viewRects, std::vector<DrawList>& drawLists,
+	sf::Transform transform, unsigned int viewMask, const SceneNode* layer) const
+{
+	transform *= getTransform();
+
+	// Nodes without bounds (layers, backgrounds, particles) are visible everywhere their parent is
+	sf::FloatRect bounds = getBoundingRect();
+	if (bounds.width > 0.f || bounds.height > 0.f)
+	{
+		bounds = sf::FloatRect(bounds.left - CullMargin, bounds.top - CullMargin,
+			bounds.width + 2.f * CullMargin, bounds.height + 2.f * CullMargin);
+
+		for (std::size_t i = 0; i < viewRects.size(); ++i)
+		{
+			if (!bounds.intersects(viewRects[i]))
+				viewMask &= ~(1u << i);
+		}
+
+		// Entities take their attachments with them
+		if (viewMask == 0)
+			return;
+	}
+
+	// The children of the root are the layers
+	if (!layer && mParent)
+		layer = this;
+
+	DrawCommand command = { this, transform, layer };
+	for (std::size_t i = 0; i < viewRects.size(); ++i)
+	{
+		if (viewMask & (1u << i))
+			drawLists[i].push_back(command);
+	}
+
+	FOREACH(const Ptr& child, mChildren)
+		child->collectVisible(viewRects, drawLists, transform, viewMask, layer);
+}
+
 void SceneNode::drawBoundingRect(sf::RenderTarget& target, sf::RenderStates) const
 {
 	sf::FloatRect rect = getBoundingRect();
@@ -90,6 +209,27 @@ void SceneNode::drawBoundingRect(sf::RenderTarget& target, sf::RenderStates) con
 	target.draw(shape);
 }
 
+void SceneNode::sortChildren(const std::function<bool(const SceneNode&, const SceneNode&)>& less)
+{
+	// Stable, so that children comparing equal keep their drawing order
+	std::stable_sort(mChildren.begin(), mChildren.end(), [&] (const Ptr& lhs, const Ptr& rhs)
+	{
+		return less(*lhs, *rhs);
+	});
+}
+
+void SceneNode::translateChildren(sf::Vector2f offset)
+{
+	// Only direct children move, grandchildren are positioned relative to them
+	FOREACH(Ptr& child, mChildren)
+		child->translateOrigin(offset);
+}
+
+void SceneNode::translateOrigin(sf::Vector2f offset)
+{
+	move(offset);
+}
+
 sf::Vector2f SceneNode::getWorldPosition() const
 {
 	return getWorldTransform() * sf::Vector2f();
@@ -138,14 +278,25 @@ void SceneNode::checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPai
 		child->checkNodeCollision(node, collisionPairs);
 }
 
-void SceneNode::removeWrecks()
+void SceneNode::removeWrecks(std::vector<Ptr>& wrecks)
 {
-	// Remove all children which request so
-	auto wreckfieldBegin = std::remove_if (mChildren.begin(), mChildren.end(), std::mem_fn(&SceneNode::isMarkedForRemoval));
+	// Move all children which request so out of the graph, the caller decides whether they are deleted or reused.
+	// The remaining children keep their order
+	auto wreckfieldBegin = std::stable_partition(mChildren.begin(), mChildren.end(), [] (const Ptr& child)
+	{
+		return !child->isMarkedForRemoval();
+	});
+
+	for (auto itr = wreckfieldBegin; itr != mChildren.end(); ++itr)
+	{
+		(*itr)->mParent = nullptr;
+		wrecks.push_back(std::move(*itr));
+	}
 	mChildren.erase(wreckfieldBegin, mChildren.end());
 
 	// Call function recursively for all remaining children
-	std::for_each(mChildren.begin(), mChildren.end(), std::mem_fn(&SceneNode::removeWrecks));
+	FOREACH(Ptr& child, mChildren)
+		child->removeWrecks(wrecks);
 }
 
 sf::FloatRect SceneNode::getBoundingRect() const
@@ -0,0 +1,163 @@
+#include "Snapshot.hpp"
+#include "Foreach.hpp"
+
+#include <cstring>
+
+
+namespace
+{
+	// FNV-1a, cheap and good enough to tell two simulations apart
+	const sf::Uint32 FnvOffsetBasis = 2166136261u;
+	const sf::Uint32 FnvPrime = 16777619u;
+
+	template <typename T>
+	void hashValue(sf::Uint32& hash, const T& value)
+	{
+		unsigned char bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+		{
+			hash ^= bytes[i];
+			hash *= FnvPrime;
+		}
+	}
+}
+
+EntityState::EntityState()
+: id(0)
+, kind(AircraftEntity)
+, type(0)
+, position()
+, velocity()
+, rotation(0.f)
+, hitpoints(0)
+, identifier(0)
+, formation(0)
+, fireRateLevel(0)
+, spreadLevel(0)
+, missileAmmo(0)
+, speed(0)
+, movementPattern(0)
+, hasBehavior(false)
+, behaviorStep(0)
+, behaviorDelay(0)
+, burstShots(0)
+, isFiringBurstShot(false)
+, patternTime(sf::Time::Zero)
+, fireCooldown(sf::Time::Zero)
+, updateCounter(0)
+, detailLevel(0)
+, skippedTime(sf::Time::Zero)
+, showExplosion(true)
+, playedExplosionSound(false)
+, spawnedPickup(false)
+, targetDirection()
+{
+}
+
+FormationState::FormationState()
+: id(0)
+, position()
+, velocity()
+, speed(0.f)
+, pattern(0)
+, directionIndex(0)
+, travelledDistance(0.f)
+{
+}
+
+BulletState::BulletState()
+: id(0)
+, type(0)
+, position()
+, direction()
+, speed(0.f)
+{
+}
+
+DroneState::DroneState()
+: position()
+, velocity()
+, hitpoints(0)
+{
+}
+
+ExplosionState::ExplosionState()
+: position()
+, age(sf::Time::Zero)
+{
+}
+
+WorldSnapshot::WorldSnapshot()
+: frame(0)
+, originOffset(0.0)
+, viewCenter()
+, spawnChunk(0)
+, chunkOrigin()
+, nextSpawnPoint(0)
+, nextEntityId(0)
+, nextBulletId(0)
+, score(0)
+, playerExplosionTime(sf::Time::Zero)
+, randomEngine()
+, entities()
+, formations()
+, bullets()
+, swarms()
+, explosions()
+{
+}
+
+sf::Uint32 computeChecksum(const WorldSnapshot& snapshot)
+{
+	sf::Uint32 hash = FnvOffsetBasis;
+
+	hashValue(hash, snapshot.viewCenter.y - snapshot.originOffset);
+	hashValue(hash, snapshot.score);
+	hashValue(hash, snapshot.nextEntityId);
+	hashValue(hash, snapshot.playerExplosionTime.asMicroseconds());
+
+	// Wrecks are purely cosmetic, only living entities take part
+	FOREACH(const EntityState& entity, snapshot.entities)
+	{
+		if (entity.hitpoints <= 0)
+			continue;
+
+		hashValue(hash, entity.id);
+		hashValue(hash, entity.type);
+		hashValue(hash, entity.position.x);
+		hashValue(hash, entity.position.y);
+		hashValue(hash, entity.hitpoints);
+		hashValue(hash, entity.missileAmmo);
+	}
+
+	// Members are hashed with their offsets, the formations add the shared part
+	FOREACH(const FormationState& formation, snapshot.formations)
+	{
+		hashValue(hash, formation.id);
+		hashValue(hash, formation.position.x);
+		hashValue(hash, formation.position.y);
+	}
+
+	hashValue(hash, static_cast<sf::Uint32>(snapshot.bullets.size()));
+	FOREACH(const BulletState& bullet, snapshot.bullets)
+	{
+		hashValue(hash, bullet.id);
+		hashValue(hash, bullet.position.x);
+		hashValue(hash, bullet.position.y);
+	}
+
+	FOREACH(const SwarmState& swarm, snapshot.swarms)
+	{
+		hashValue(hash, static_cast<sf::Uint32>(swarm.drones.size()));
+		FOREACH(const DroneState& drone, swarm.drones)
+		{
+			hashValue(hash, drone.position.x);
+			hashValue(hash, drone.position.y);
+			hashValue(hash, drone.hitpoints);
+		}
+	}
+
+	return hash;
+}
@@ -1,4 +1,5 @@
 #include "SoundPlayer.hpp"
+#include "Foreach.hpp"
 
 #include <SFML/Audio/Listener.hpp>
 
@@ -18,6 +19,7 @@ namespace
 SoundPlayer::SoundPlayer()
 : mSoundBuffers()
 , mSounds()
+, mMuted(false)
 {
 	mSoundBuffers.load(SoundEffect::AlliedGunfire,	"Media/Sound/AlliedGunfire.wav");
 	mSoundBuffers.load(SoundEffect::EnemyGunfire,	"Media/Sound/EnemyGunfire.wav");
@@ -38,6 +40,9 @@ void SoundPlayer::play(SoundEffect::ID effect)
 
 void SoundPlayer::play(SoundEffect::ID effect, sf::Vector2f position)
 {
+	if (mMuted)
+		return;
+
 	mSounds.push_back(sf::Sound());
 	sf::Sound& sound = mSounds.back();
 
@@ -49,6 +54,16 @@ void SoundPlayer::play(SoundEffect::ID effect, sf::Vector2f position)
 	sound.play();
 }
 
+void SoundPlayer::setMuted(bool muted)
+{
+	mMuted = muted;
+}
+
+std::size_t SoundPlayer::getSoundCount() const
+{
+	return mSounds.size();
+}
+
 void SoundPlayer::removeStoppedSounds()
 {
 	mSounds.remove_if([] (const sf::Sound& s)
@@ -57,6 +72,16 @@ void SoundPlayer::removeStoppedSounds()
 	});
 }
 
+void SoundPlayer::translateSounds(sf::Vector2f offset)
+{
+	// Keep playing sounds in place when the world coordinates are shifted
+	FOREACH(sf::Sound& sound, mSounds)
+	{
+		sf::Vector3f position = sound.getPosition();
+		sound.setPosition(position.x + offset.x, position.y - offset.y, position.z);
+	}
+}
+
 void SoundPlayer::setListenerPosition(sf::Vector2f position)
 {
 	sf::Listener::setPosition(position.x, -position.y, ListenerZ);
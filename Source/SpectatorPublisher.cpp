@@ -0,0 +1,148 @@
+#include "SpectatorPublisher.hpp"
+#include "World.hpp"
+
+#include <SFML/System/Clock.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+
+
+namespace
+{
+	// A keyframe every few seconds lets late or unlucky spectators catch up
+	const sf::Time KeyframeInterval = sf::seconds(2.f);
+
+	// Unused budget is only saved up for a short while, so that bursts stay small
+	const float MaxAllowanceSeconds = 0.25f;
+}
+
+SpectatorPublisher::SpectatorPublisher()
+: mLink()
+, mEncoder()
+, mSnapshot()
+, mPacket()
+, mEnabled(false)
+, mBudget(64.f * 1024.f)
+, mAllowance(0.f)
+, mSinceKeyframe(sf::Time::Zero)
+, mStatisticsUpdateTime(sf::Time::Zero)
+, mStatisticsBytes(0)
+, mStatisticsFrames(0)
+, mStatisticsEncodeTime(sf::Time::Zero)
+, mStatisticsMaxEncodeTime(sf::Time::Zero)
+, mBytesPerSecond(0)
+, mFramesPerSecond(0)
+, mAverageEncodeTime(sf::Time::Zero)
+, mMaxEncodeTime(sf::Time::Zero)
+{
+	// Streaming is switched on by Spectator.txt, made of "key value" lines
+	std::ifstream file("Spectator.txt");
+	if (!file)
+		return;
+
+	std::string address = "127.0.0.1";
+	unsigned short port = 50100;
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		std::string key;
+		stream >> key;
+
+		if (key == "viewer_address")
+			stream >> address;
+		else if (key == "port")
+			stream >> port;
+		else if (key == "budget_kbps")
+		{
+			float kilobytes = 0.f;
+			stream >> kilobytes;
+			mBudget = kilobytes * 1024.f;
+		}
+	}
+
+	mEnabled = mLink.bind(sf::Socket::AnyPort);
+	mLink.setRemote(sf::IpAddress(address), port);
+}
+
+bool SpectatorPublisher::isEnabled() const
+{
+	return mEnabled;
+}
+
+void SpectatorPublisher::update(sf::Time dt, World& world)
+{
+	if (!mEnabled)
+		return;
+
+	updateStatistics(dt);
+
+	mAllowance = std::min(mAllowance + mBudget * dt.asSeconds(), mBudget * MaxAllowanceSeconds);
+	mSinceKeyframe += dt;
+
+	// Over budget: skip the tick, without even encoding it
+	if (mAllowance < 0.f)
+		return;
+
+	if (mSinceKeyframe >= KeyframeInterval)
+	{
+		mEncoder.requestKeyframe();
+		mSinceKeyframe = sf::Time::Zero;
+	}
+
+	sf::Clock clock;
+	world.saveState(mSnapshot);
+	mEncoder.encode(mSnapshot, static_cast<sf::Uint8>(World::getLevel() - 1), mPacket);
+	sf::Time encodeTime = clock.getElapsedTime();
+
+	mLink.send(mPacket);
+
+	// A large keyframe may overdraw the allowance, the following ticks pay it back
+	mAllowance -= mPacket.getDataSize();
+
+	mStatisticsBytes += mPacket.getDataSize();
+	mStatisticsFrames += 1;
+	mStatisticsEncodeTime += encodeTime;
+	mStatisticsMaxEncodeTime = std::max(mStatisticsMaxEncodeTime, encodeTime);
+}
+
+std::size_t SpectatorPublisher::getBytesPerSecond() const
+{
+	return mBytesPerSecond;
+}
+
+std::size_t SpectatorPublisher::getFramesPerSecond() const
+{
+	return mFramesPerSecond;
+}
+
+sf::Time SpectatorPublisher::getAverageEncodeTime() const
+{
+	return mAverageEncodeTime;
+}
+
+sf::Time SpectatorPublisher::getMaxEncodeTime() const
+{
+	return mMaxEncodeTime;
+}
+
+void SpectatorPublisher::updateStatistics(sf::Time dt)
+{
+	mStatisticsUpdateTime += dt;
+	if (mStatisticsUpdateTime < sf::seconds(1.0f))
+		return;
+
+	mBytesPerSecond = mStatisticsBytes;
+	mFramesPerSecond = mStatisticsFrames;
+	mAverageEncodeTime = mStatisticsFrames > 0 ? mStatisticsEncodeTime / static_cast<sf::Int64>(mStatisticsFrames) : sf::Time::Zero;
+	mMaxEncodeTime = mStatisticsMaxEncodeTime;
+
+	mStatisticsUpdateTime -= sf::seconds(1.0f);
+	mStatisticsBytes = 0;
+	mStatisticsFrames = 0;
+	mStatisticsEncodeTime = sf::Time::Zero;
+	mStatisticsMaxEncodeTime = sf::Time::Zero;
+}
@@ -0,0 +1,150 @@
+#include "SpectatorState.hpp"
+#include "Snapshot.hpp"
+#include "Utility.hpp"
+#include "Foreach.hpp"
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/View.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+
+
+SpectatorState::SpectatorState(StateStack& stack, Context context)
+: State(stack, context)
+, mLink()
+, mDecoder()
+, mSinceLastFrame(sf::Time::Zero)
+, mTextures()
+, mAircraftTable(initializeAircraftData())
+, mProjectileTable(initializeProjectileData())
+, mPickupTable(initializePickupData())
+, mBackground()
+, mEntitySprite()
+, mScoreText()
+, mStatusText()
+{
+	// Listens on the port of Spectator.txt, shared with the publishing side
+	unsigned short port = 50100;
+
+	std::ifstream file("Spectator.txt");
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		std::string key;
+		stream >> key;
+
+		if (key == "port")
+			stream >> port;
+	}
+
+	if (!mLink.bind(port))
+		throw std::runtime_error("SpectatorState - Failed to bind port " + toString(port));
+
+	mTextures.load(Textures::Entities, "Media/Textures/Entities.png");
+	mTextures.load(Textures::Jungle, "Media/Textures/Jungle.png");
+	mTextures.load(Textures::Space1, "Media/Textures/Space1.png");
+	mTextures.load(Textures::Space2, "Media/Textures/Space2.png");
+	mTextures.load(Textures::Space3, "Media/Textures/Space3.png");
+
+	mScoreText.setFont(context.fonts->get(Fonts::Arcade));
+	mScoreText.setPosition(700.f, 725.f);
+	mScoreText.setCharacterSize(20u);
+
+	mStatusText.setFont(context.fonts->get(Fonts::Arcade));
+	mStatusText.setString("Waiting for a game...");
+	centerOrigin(mStatusText);
+	mStatusText.setPosition(sf::Vector2f(context.window->getSize() / 2u));
+}
+
+void SpectatorState::draw()
+{
+	sf::RenderWindow& window = *getContext().window;
+	window.setView(window.getDefaultView());
+
+	if (!mDecoder.isSynchronized() && mDecoder.getFrame().tick == 0)
+	{
+		window.draw(mStatusText);
+		return;
+	}
+
+	const SpectatorFrame& frame = mDecoder.getFrame();
+	sf::Vector2f viewSize = window.getDefaultView().getSize();
+
+	// The background scrolls with the absolute view position, like the world's tiled sprite
+	static const Textures::ID Backgrounds[] = { Textures::Jungle, Textures::Space1, Textures::Space2, Textures::Space3 };
+	sf::Texture& background = mTextures.get(Backgrounds[std::min<int>(std::max<int>(frame.level, 1), 4) - 1]);
+	background.setRepeated(true);
+
+	mBackground.setTexture(background);
+	mBackground.setTextureRect(sf::IntRect(0, frame.scroll + static_cast<int>(viewSize.y / 2.f), static_cast<int>(viewSize.x), static_cast<int>(viewSize.y)));
+	window.draw(mBackground);
+
+	sf::View view(sf::Vector2f(dequantizePosition(frame.viewX), dequantizePosition(frame.viewY)), viewSize);
+	window.setView(view);
+
+	// One sprite, reconfigured for every entity
+	FOREACH(const SpectatorEntity& entity, frame.entities)
+	{
+		if (entity.kind == EntityState::AircraftEntity && entity.type < mAircraftTable.size())
+		{
+			mEntitySprite.setTexture(mTextures.get(mAircraftTable[entity.type].texture));
+			mEntitySprite.setTextureRect(mAircraftTable[entity.type].textureRect);
+		}
+		else if (entity.kind == EntityState::ProjectileEntity && entity.type < mProjectileTable.size())
+		{
+			mEntitySprite.setTexture(mTextures.get(mProjectileTable[entity.type].texture));
+			mEntitySprite.setTextureRect(mProjectileTable[entity.type].textureRect);
+		}
+		else if (entity.kind == EntityState::PickupEntity && entity.type < mPickupTable.size())
+		{
+			mEntitySprite.setTexture(mTextures.get(mPickupTable[entity.type].texture));
+			mEntitySprite.setTextureRect(mPickupTable[entity.type].textureRect);
+		}
+		else
+		{
+			continue;
+		}
+
+		centerOrigin(mEntitySprite);
+		mEntitySprite.setPosition(dequantizePosition(entity.x), dequantizePosition(entity.y));
+		mEntitySprite.setRotation(dequantizeRotation(entity.rotation));
+		window.draw(mEntitySprite);
+	}
+
+	window.setView(window.getDefaultView());
+	window.draw(mScoreText);
+
+	if (mSinceLastFrame > sf::seconds(1.f))
+		window.draw(mStatusText);
+}
+
+bool SpectatorState::update(sf::Time dt)
+{
+	mSinceLastFrame += dt;
+
+	// Only the newest frame matters, older ones are decoded just to keep the deltas chained
+	sf::Packet packet;
+	while (mLink.receive(packet))
+	{
+		if (mDecoder.decode(packet))
+			mSinceLastFrame = sf::Time::Zero;
+	}
+
+	mScoreText.setString("Score: " + toString(mDecoder.getFrame().score));
+	return true;
+}
+
+bool SpectatorState::handleEvent(const sf::Event& event)
+{
+	if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
+	{
+		requestStackPop();
+		requestStackPush(States::Menu);
+	}
+
+	return true;
+}
@@ -0,0 +1,362 @@
+#include "SpectatorStream.hpp"
+#include "Snapshot.hpp"
+#include "Projectile.hpp"
+#include "Foreach.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+
+namespace
+{
+	// Quarter pixels are plenty for drawing, and keep the battlefield well inside 16 bits
+	const float PositionScale = 4.f;
+
+	enum ChangeMask
+	{
+		Spawned			= 1 << 0,
+		Position		= 1 << 1,
+		PositionDelta	= 1 << 2,
+		Rotation		= 1 << 3,
+		Hitpoints		= 1 << 4,
+
+		Everything		= Spawned | Position | Rotation | Hitpoints,
+	};
+
+	const sf::Uint8 KeyframeFlag = 1 << 0;
+
+	sf::Uint8 computeChanges(const SpectatorEntity& previous, const SpectatorEntity& current)
+	{
+		sf::Uint8 mask = 0;
+
+		int dx = current.x - previous.x;
+		int dy = current.y - previous.y;
+		if (dx != 0 || dy != 0)
+			mask |= (std::abs(dx) <= 127 && std::abs(dy) <= 127) ? PositionDelta : Position;
+
+		if (current.rotation != previous.rotation)
+			mask |= Rotation;
+
+		if (current.hitpoints != previous.hitpoints)
+			mask |= Hitpoints;
+
+		return mask;
+	}
+}
+
+SpectatorEntity::SpectatorEntity()
+: id(0)
+, kind(0)
+, type(0)
+, x(0)
+, y(0)
+, rotation(0)
+, hitpoints(0)
+{
+}
+
+SpectatorFrame::SpectatorFrame()
+: tick(0)
+, level(0)
+, viewX(0)
+, viewY(0)
+, scroll(0)
+, score(0)
+, entities()
+{
+}
+
+sf::Int16 quantizePosition(float value)
+{
+	float scaled = std::floor(value * PositionScale + 0.5f);
+	return static_cast<sf::Int16>(std::max(-32768.f, std::min(scaled, 32767.f)));
+}
+
+float dequantizePosition(sf::Int16 value)
+{
+	return value / PositionScale;
+}
+
+sf::Uint8 quantizeRotation(float degrees)
+{
+	return static_cast<sf::Uint8>(static_cast<int>(std::floor(degrees * 256.f / 360.f + 0.5f)) & 0xff);
+}
+
+float dequantizeRotation(sf::Uint8 value)
+{
+	return value * 360.f / 256.f;
+}
+
+SpectatorEncoder::SpectatorEncoder()
+: mPrevious()
+, mCurrent()
+, mChanges()
+, mRemoved()
+, mTick(0)
+, mKeyframe(true)
+{
+}
+
+void SpectatorEncoder::encode(const WorldSnapshot& snapshot, sf::Uint8 level, sf::Packet& packet)
+{
+	quantize(snapshot, level);
+
+	mChanges.clear();
+	mRemoved.clear();
+
+	// Both entity lists are sorted by ID, so a single merge finds every difference
+	const std::vector<SpectatorEntity>& previous = mPrevious.entities;
+	const std::vector<SpectatorEntity>& current = mCurrent.entities;
+	std::size_t i = 0;
+	std::size_t j = 0;
+
+	while (i < previous.size() || j < current.size())
+	{
+		if (j == current.size() || (i < previous.size() && previous[i].id < current[j].id))
+		{
+			if (!mKeyframe)
+				mRemoved.push_back(previous[i].id);
+			++i;
+		}
+		else if (i == previous.size() || current[j].id < previous[i].id || mKeyframe)
+		{
+			Change change = { j, 0, Everything };
+			mChanges.push_back(change);
+
+			if (i < previous.size() && previous[i].id == current[j].id)
+				++i;
+			++j;
+		}
+		else
+		{
+			Change change = { j, i, computeChanges(previous[i], current[j]) };
+			if (change.mask != 0)
+				mChanges.push_back(change);
+			++i;
+			++j;
+		}
+	}
+
+	packet.clear();
+	packet << static_cast<sf::Uint8>(mKeyframe ? KeyframeFlag : 0) << mCurrent.tick << mPrevious.tick
+		<< mCurrent.level << mCurrent.viewX << mCurrent.viewY << mCurrent.scroll << mCurrent.score;
+
+	packet << static_cast<sf::Uint16>(mRemoved.size());
+	FOREACH(sf::Uint32 id, mRemoved)
+		packet << id;
+
+	packet << static_cast<sf::Uint16>(mChanges.size());
+	FOREACH(const Change& change, mChanges)
+		writeChange(change, packet);
+
+	// The next frame is written relative to this one
+	std::swap(mPrevious, mCurrent);
+	mKeyframe = false;
+}
+
+void SpectatorEncoder::requestKeyframe()
+{
+	mKeyframe = true;
+}
+
+void SpectatorEncoder::quantize(const WorldSnapshot& snapshot, sf::Uint8 level)
+{
+	mCurrent.tick = ++mTick;
+	mCurrent.level = level;
+	mCurrent.viewX = quantizePosition(snapshot.viewCenter.x);
+	mCurrent.viewY = quantizePosition(snapshot.viewCenter.y);
+	mCurrent.scroll = static_cast<sf::Int32>(std::floor(snapshot.viewCenter.y - snapshot.originOffset + 0.5));
+	mCurrent.score = snapshot.score;
+
+	// Wrecks are left out, spectators only see what is still flying
+	mCurrent.entities.clear();
+	FOREACH(const EntityState& state, snapshot.entities)
+	{
+		if (state.hitpoints <= 0)
+			continue;
+
+		// Formation members are saved relative to their formation
+		sf::Vector2f position = state.position;
+		if (state.formation != 0)
+		{
+			FOREACH(const FormationState& formation, snapshot.formations)
+			{
+				if (formation.id == state.formation)
+					position += formation.position;
+			}
+		}
+
+		SpectatorEntity entity;
+		entity.id = state.id;
+		entity.kind = state.kind;
+		entity.type = state.type;
+		entity.x = quantizePosition(position.x);
+		entity.y = quantizePosition(position.y);
+		entity.rotation = quantizeRotation(state.rotation);
+		entity.hitpoints = static_cast<sf::Int16>(std::min(state.hitpoints, 32767));
+		mCurrent.entities.push_back(entity);
+	}
+
+	// Gun bullets follow, their IDs are above all entity IDs. Pattern bullets come by the
+	// thousand and would swamp the stream, spectators don't see them
+	std::size_t firstBullet = mCurrent.entities.size();
+	FOREACH(const BulletState& bullet, snapshot.bullets)
+	{
+		if (bullet.type == Projectile::PatternBullet)
+			continue;
+
+		SpectatorEntity entity;
+		entity.id = bullet.id;
+		entity.kind = EntityState::ProjectileEntity;
+		entity.type = bullet.type;
+		entity.x = quantizePosition(bullet.position.x);
+		entity.y = quantizePosition(bullet.position.y);
+		entity.rotation = 0;
+		entity.hitpoints = 1;
+		mCurrent.entities.push_back(entity);
+	}
+
+	std::sort(mCurrent.entities.begin() + firstBullet, mCurrent.entities.end(), [] (const SpectatorEntity& lhs, const SpectatorEntity& rhs)
+	{
+		return lhs.id < rhs.id;
+	});
+}
+
+void SpectatorEncoder::writeChange(const Change& change, sf::Packet& packet) const
+{
+	const SpectatorEntity& entity = mCurrent.entities[change.current];
+	packet << entity.id << change.mask;
+
+	if (change.mask & Spawned)
+		packet << entity.kind << entity.type;
+
+	if (change.mask & Position)
+	{
+		packet << entity.x << entity.y;
+	}
+	else if (change.mask & PositionDelta)
+	{
+		const SpectatorEntity& previous = mPrevious.entities[change.previous];
+		packet << static_cast<sf::Int8>(entity.x - previous.x) << static_cast<sf::Int8>(entity.y - previous.y);
+	}
+
+	if (change.mask & Rotation)
+		packet << entity.rotation;
+
+	if (change.mask & Hitpoints)
+		packet << entity.hitpoints;
+}
+
+SpectatorDecoder::SpectatorDecoder()
+: mFrame()
+, mNext()
+, mRemoved()
+, mSynchronized(false)
+{
+}
+
+bool SpectatorDecoder::decode(sf::Packet& packet)
+{
+	sf::Uint8 flags;
+	sf::Uint32 baseTick;
+	sf::Uint16 removedCount;
+
+	if (!(packet >> flags >> mNext.tick >> baseTick >> mNext.level >> mNext.viewX >> mNext.viewY >> mNext.scroll >> mNext.score))
+		return false;
+
+	// A delta is useless without the frame it was taken against, wait for the next keyframe then
+	bool keyframe = (flags & KeyframeFlag) != 0;
+	bool hasBase = mSynchronized && baseTick == mFrame.tick;
+
+	// Until this packet is read completely, the current frame is no base for further deltas
+	mSynchronized = false;
+	if (!keyframe && !hasBase)
+		return false;
+	if (keyframe)
+		mFrame.entities.clear();
+
+	if (!(packet >> removedCount))
+		return false;
+
+	mRemoved.resize(removedCount);
+	FOREACH(sf::Uint32& id, mRemoved)
+		packet >> id;
+
+	const std::vector<SpectatorEntity>& previous = mFrame.entities;
+	std::size_t i = 0;
+
+	// Keep the previous entities that are neither removed nor changed, in ID order
+	auto copyUnchangedBefore = [&] (sf::Uint64 id)
+	{
+		for (; i < previous.size() && previous[i].id < id; ++i)
+		{
+			if (!std::binary_search(mRemoved.begin(), mRemoved.end(), previous[i].id))
+				mNext.entities.push_back(previous[i]);
+		}
+	};
+
+	sf::Uint16 changeCount;
+	if (!(packet >> changeCount))
+		return false;
+
+	mNext.entities.clear();
+	for (sf::Uint16 n = 0; n < changeCount; ++n)
+	{
+		sf::Uint32 id;
+		sf::Uint8 mask;
+		if (!(packet >> id >> mask))
+			return false;
+
+		copyUnchangedBefore(id);
+
+		SpectatorEntity entity;
+		if (i < previous.size() && previous[i].id == id)
+			entity = previous[i++];
+		else if (!(mask & Spawned))
+			return false;
+
+		entity.id = id;
+		if (mask & Spawned)
+			packet >> entity.kind >> entity.type;
+
+		if (mask & Position)
+		{
+			packet >> entity.x >> entity.y;
+		}
+		else if (mask & PositionDelta)
+		{
+			sf::Int8 dx, dy;
+			packet >> dx >> dy;
+			entity.x = static_cast<sf::Int16>(entity.x + dx);
+			entity.y = static_cast<sf::Int16>(entity.y + dy);
+		}
+
+		if (mask & Rotation)
+			packet >> entity.rotation;
+
+		if (mask & Hitpoints)
+			packet >> entity.hitpoints;
+
+		mNext.entities.push_back(entity);
+	}
+
+	copyUnchangedBefore(sf::Uint64(1) << 32);
+
+	if (!packet)
+		return false;
+
+	std::swap(mFrame, mNext);
+	mSynchronized = true;
+	return true;
+}
+
+bool SpectatorDecoder::isSynchronized() const
+{
+	return mSynchronized;
+}
+
+const SpectatorFrame& SpectatorDecoder::getFrame() const
+{
+	return mFrame;
+}
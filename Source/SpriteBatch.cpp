@@ -0,0 +1,80 @@
+#include "SpriteBatch.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+
+#include <cmath>
+
+
+SpriteBatch::SpriteBatch()
+: mBatches()
+, mUsedBatches(0)
+{
+}
+
+void SpriteBatch::draw(const sf::Sprite& sprite, const sf::Transform& transform)
+{
+	const sf::Texture* texture = sprite.getTexture();
+	if (!texture)
+		return;
+
+	// A frame only uses a few textures, a linear search is all it takes
+	std::size_t index = 0;
+	while (index < mUsedBatches && mBatches[index].texture != texture)
+		++index;
+
+	if (index == mUsedBatches)
+	{
+		if (mUsedBatches == mBatches.size())
+		{
+			mBatches.push_back(Batch());
+			mBatches.back().vertices.setPrimitiveType(sf::Quads);
+		}
+
+		mBatches[index].texture = texture;
+		mBatches[index].vertices.clear();
+		++mUsedBatches;
+	}
+
+	// Same corners as sf::Sprite, a negative texture rect size flips the sprite
+	sf::Transform combined = transform * sprite.getTransform();
+	sf::IntRect rect = sprite.getTextureRect();
+	sf::Color color = sprite.getColor();
+
+	float width = static_cast<float>(std::abs(rect.width));
+	float height = static_cast<float>(std::abs(rect.height));
+	float left = static_cast<float>(rect.left);
+	float right = left + static_cast<float>(rect.width);
+	float top = static_cast<float>(rect.top);
+	float bottom = top + static_cast<float>(rect.height);
+
+	sf::VertexArray& vertices = mBatches[index].vertices;
+	vertices.append(sf::Vertex(combined.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+	vertices.append(sf::Vertex(combined.transformPoint(width, 0.f), color, sf::Vector2f(right, top)));
+	vertices.append(sf::Vertex(combined.transformPoint(width, height), color, sf::Vector2f(right, bottom)));
+	vertices.append(sf::Vertex(combined.transformPoint(0.f, height), color, sf::Vector2f(left, bottom)));
+}
+
+void SpriteBatch::flush(sf::RenderTarget& target, sf::RenderStates states)
+{
+	// The vertices are already in world coordinates
+	states.transform = sf::Transform::Identity;
+
+	for (std::size_t i = 0; i < mUsedBatches; ++i)
+	{
+		states.texture = mBatches[i].texture;
+		target.draw(mBatches[i].vertices, states);
+		mBatches[i].vertices.clear();
+	}
+
+	mUsedBatches = 0;
+}
+
+std::size_t SpriteBatch::getSpriteCount() const
+{
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < mUsedBatches; ++i)
+		count += mBatches[i].vertices.getVertexCount() / 4;
+
+	return count;
+}
@@ -0,0 +1,523 @@
+#include "SwarmNode.hpp"
+#include "Aircraft.hpp"
+#include "BulletNode.hpp"
+#include "DataTables.hpp"
+#include "Snapshot.hpp"
+#include "ResourceHolder.hpp"
+#include "Foreach.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SWARMNODE_SSE2
+	#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	const std::vector<AircraftData> Table = initializeAircraftData();
+
+	// Drones look like small Raptors
+	const sf::Vector2f DroneSize(24.f, 18.f);
+	const int DroneHitpoints = 10;
+	const int DroneDamage = 5;
+	const float SpawnRadius = 120.f;
+	const float SpawnSpeed = 80.f;
+
+	// Neighbors are searched within one grid cell around the drone's own
+	const float NeighborRadius = 40.f;
+	const float SeparationRadius = 18.f;
+	const std::size_t MaxGridSize = 64;
+
+	// Steering weights, in accelerations per unit of each rule
+	const float Cohesion = 1.5f;
+	const float Alignment = 2.f;
+	const float Separation = 4000.f;
+	const float Pursuit = 220.f;
+	const float MaxSpeed = 170.f;
+
+	// Steers every drone by its neighborhood and the target, then moves it. The vector and the scalar
+	// path do the same single precision operations in the same order, so peers using either agree
+	void steer(float* positionX, float* positionY, float* velocityX, float* velocityY,
+		const float* centerX, const float* centerY, const float* headingX, const float* headingY,
+		const float* separationX, const float* separationY, std::size_t count, sf::Vector2f target, float seconds)
+	{
+		std::size_t i = 0;
+
+#ifdef SWARMNODE_SSE2
+		const __m128 cohesion = _mm_set1_ps(Cohesion);
+		const __m128 alignment = _mm_set1_ps(Alignment);
+		const __m128 separation = _mm_set1_ps(Separation);
+		const __m128 pursuit = _mm_set1_ps(Pursuit);
+		const __m128 maxSpeed = _mm_set1_ps(MaxSpeed);
+		const __m128 one = _mm_set1_ps(1.f);
+		const __m128 epsilon = _mm_set1_ps(0.001f);
+		const __m128 targetX = _mm_set1_ps(target.x);
+		const __m128 targetY = _mm_set1_ps(target.y);
+		const __m128 time = _mm_set1_ps(seconds);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 px = _mm_loadu_ps(positionX + i);
+			__m128 py = _mm_loadu_ps(positionY + i);
+			__m128 vx = _mm_loadu_ps(velocityX + i);
+			__m128 vy = _mm_loadu_ps(velocityY + i);
+
+			__m128 tx = _mm_sub_ps(targetX, px);
+			__m128 ty = _mm_sub_ps(targetY, py);
+			__m128 targetLength = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), one));
+
+			__m128 ax = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(centerX + i), px), cohesion);
+			ax = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(headingX + i), vx), alignment));
+			ax = _mm_add_ps(ax, _mm_mul_ps(_mm_loadu_ps(separationX + i), separation));
+			ax = _mm_add_ps(ax, _mm_mul_ps(_mm_div_ps(tx, targetLength), pursuit));
+
+			__m128 ay = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(centerY + i), py), cohesion);
+			ay = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(headingY + i), vy), alignment));
+			ay = _mm_add_ps(ay, _mm_mul_ps(_mm_loadu_ps(separationY + i), separation));
+			ay = _mm_add_ps(ay, _mm_mul_ps(_mm_div_ps(ty, targetLength), pursuit));
+
+			vx = _mm_add_ps(vx, _mm_mul_ps(ax, time));
+			vy = _mm_add_ps(vy, _mm_mul_ps(ay, time));
+
+			__m128 speed = _mm_add_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy))), epsilon);
+			__m128 scale = _mm_min_ps(_mm_div_ps(maxSpeed, speed), one);
+			vx = _mm_mul_ps(vx, scale);
+			vy = _mm_mul_ps(vy, scale);
+
+			_mm_storeu_ps(velocityX + i, vx);
+			_mm_storeu_ps(velocityY + i, vy);
+			_mm_storeu_ps(positionX + i, _mm_add_ps(px, _mm_mul_ps(vx, time)));
+			_mm_storeu_ps(positionY + i, _mm_add_ps(py, _mm_mul_ps(vy, time)));
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			float px = positionX[i];
+			float py = positionY[i];
+			float vx = velocityX[i];
+			float vy = velocityY[i];
+
+			float tx = target.x - px;
+			float ty = target.y - py;
+			float targetLength = std::sqrt(tx * tx + ty * ty + 1.f);
+
+			float ax = (centerX[i] - px) * Cohesion;
+			ax += (headingX[i] - vx) * Alignment;
+			ax += separationX[i] * Separation;
+			ax += (tx / targetLength) * Pursuit;
+
+			float ay = (centerY[i] - py) * Cohesion;
+			ay += (headingY[i] - vy) * Alignment;
+			ay += separationY[i] * Separation;
+			ay += (ty / targetLength) * Pursuit;
+
+			vx += ax * seconds;
+			vy += ay * seconds;
+
+			float speed = std::sqrt(vx * vx + vy * vy) + 0.001f;
+			float scale = std::min(MaxSpeed / speed, 1.f);
+			vx *= scale;
+			vy *= scale;
+
+			velocityX[i] = vx;
+			velocityY[i] = vy;
+			positionX[i] = px + vx * seconds;
+			positionY[i] = py + vy * seconds;
+		}
+	}
+}
+
+SwarmNode::SwarmNode(const TextureHolder& textures, const std::vector<Aircraft*>& players)
+: SceneNode()
+, mTexture(textures.get(Table[Aircraft::Raptor].texture))
+, mPlayers(players)
+, mPositionX()
+, mPositionY()
+, mVelocityX()
+, mVelocityY()
+, mHitpoints()
+, mCenterX()
+, mCenterY()
+, mHeadingX()
+, mHeadingY()
+, mSeparationX()
+, mSeparationY()
+, mGridOrigin()
+, mGridColumns(0)
+, mGridRows(0)
+, mCellStart()
+, mCellDrones()
+, mDroneCells()
+, mVertexArray(sf::Quads)
+, mNeedsVertexUpdate(true)
+{
+}
+
+void SwarmNode::addDrones(sf::Vector2f center, std::size_t count)
+{
+	// Sunflower spiral: evenly spread, and the same on every machine without drawing random numbers
+	const float goldenAngle = 2.39996323f;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		float radius = SpawnRadius * std::sqrt((i + 0.5f) / count);
+		float angle = i * goldenAngle;
+
+		mPositionX.push_back(center.x + radius * std::cos(angle));
+		mPositionY.push_back(center.y + radius * std::sin(angle));
+		mVelocityX.push_back(0.f);
+		mVelocityY.push_back(SpawnSpeed);
+		mHitpoints.push_back(DroneHitpoints);
+	}
+
+	mNeedsVertexUpdate = true;
+}
+
+std::size_t SwarmNode::handleCollisions(BulletNode& bullets)
+{
+	std::size_t destroyed = 0;
+
+	for (std::size_t i = 0; i < mPositionX.size(); )
+	{
+		sf::FloatRect rect = getDroneRect(i);
+
+		// Ramming a player costs the drone its life
+		bool rammed = false;
+		FOREACH(Aircraft* player, mPlayers)
+		{
+			if (!player->isDestroyed() && player->getBoundingRect().intersects(rect))
+			{
+				player->damage(DroneDamage);
+				rammed = true;
+				break;
+			}
+		}
+
+		mHitpoints[i] -= bullets.removeHits(BulletNode::Allied, rect);
+		if (rammed || mHitpoints[i] <= 0)
+		{
+			if (!rammed)
+				++destroyed;
+
+			removeDrone(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	return destroyed;
+}
+
+void SwarmNode::removeOutside(const sf::FloatRect& bounds)
+{
+	// Drones arrive from above the battlefield, only the ones that flew past the bottom are gone
+	for (std::size_t i = 0; i < mPositionY.size(); )
+	{
+		if (mPositionY[i] > bounds.top + bounds.height)
+			removeDrone(i);
+		else
+			++i;
+	}
+}
+
+std::size_t SwarmNode::getDroneCount() const
+{
+	return mPositionX.size();
+}
+
+sf::Vector2f SwarmNode::getDronePosition(std::size_t index) const
+{
+	return sf::Vector2f(mPositionX[index], mPositionY[index]);
+}
+
+sf::Vector2f SwarmNode::getDroneVelocity(std::size_t index) const
+{
+	return sf::Vector2f(mVelocityX[index], mVelocityY[index]);
+}
+
+void SwarmNode::saveState(SwarmState& state) const
+{
+	state.drones.resize(mPositionX.size());
+	for (std::size_t i = 0; i < mPositionX.size(); ++i)
+	{
+		state.drones[i].position = sf::Vector2f(mPositionX[i], mPositionY[i]);
+		state.drones[i].velocity = sf::Vector2f(mVelocityX[i], mVelocityY[i]);
+		state.drones[i].hitpoints = mHitpoints[i];
+	}
+}
+
+void SwarmNode::loadState(const SwarmState& state)
+{
+	std::size_t count = state.drones.size();
+	mPositionX.resize(count);
+	mPositionY.resize(count);
+	mVelocityX.resize(count);
+	mVelocityY.resize(count);
+	mHitpoints.resize(count);
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		mPositionX[i] = state.drones[i].position.x;
+		mPositionY[i] = state.drones[i].position.y;
+		mVelocityX[i] = state.drones[i].velocity.x;
+		mVelocityY[i] = state.drones[i].velocity.y;
+		mHitpoints[i] = state.drones[i].hitpoints;
+	}
+
+	mNeedsVertexUpdate = true;
+}
+
+unsigned int SwarmNode::getCategory() const
+{
+	return Category::Swarm;
+}
+
+bool SwarmNode::isMarkedForRemoval() const
+{
+	return mPositionX.empty();
+}
+
+void SwarmNode::translateOrigin(sf::Vector2f offset)
+{
+	for (std::size_t i = 0; i < mPositionX.size(); ++i)
+	{
+		mPositionX[i] += offset.x;
+		mPositionY[i] += offset.y;
+	}
+
+	mNeedsVertexUpdate = true;
+}
+
+void SwarmNode::updateCurrent(sf::Time dt, CommandQueue&)
+{
+	if (mPositionX.empty())
+		return;
+
+	buildGrid();
+	gatherNeighbors();
+
+	steer(&mPositionX[0], &mPositionY[0], &mVelocityX[0], &mVelocityY[0],
+		&mCenterX[0], &mCenterY[0], &mHeadingX[0], &mHeadingY[0], &mSeparationX[0], &mSeparationY[0],
+		mPositionX.size(), getTarget(), dt.asSeconds());
+
+	mNeedsVertexUpdate = true;
+}
+
+void SwarmNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if (mPositionX.empty())
+		return;
+
+	if (mNeedsVertexUpdate)
+	{
+		computeVertices();
+		mNeedsVertexUpdate = false;
+	}
+
+	states.texture = &mTexture;
+	target.draw(mVertexArray, states);
+}
+
+void SwarmNode::buildGrid()
+{
+	std::size_t count = mPositionX.size();
+
+	// The grid covers the swarm's bounding box, a scattered swarm shares the outer cells
+	float minX = *std::min_element(mPositionX.begin(), mPositionX.end());
+	float maxX = *std::max_element(mPositionX.begin(), mPositionX.end());
+	float minY = *std::min_element(mPositionY.begin(), mPositionY.end());
+	float maxY = *std::max_element(mPositionY.begin(), mPositionY.end());
+
+	mGridOrigin = sf::Vector2f(minX, minY);
+	mGridColumns = std::min(static_cast<std::size_t>((maxX - minX) / NeighborRadius) + 1, MaxGridSize);
+	mGridRows = std::min(static_cast<std::size_t>((maxY - minY) / NeighborRadius) + 1, MaxGridSize);
+
+	// Counting sort of the drones by cell
+	mCellStart.assign(mGridColumns * mGridRows + 1, 0);
+	mCellDrones.resize(count);
+	mDroneCells.resize(count);
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		std::size_t column = std::min(static_cast<std::size_t>((mPositionX[i] - minX) / NeighborRadius), mGridColumns - 1);
+		std::size_t row = std::min(static_cast<std::size_t>((mPositionY[i] - minY) / NeighborRadius), mGridRows - 1);
+
+		mDroneCells[i] = row * mGridColumns + column;
+		++mCellStart[mDroneCells[i] + 1];
+	}
+
+	for (std::size_t cell = 1; cell < mCellStart.size(); ++cell)
+		mCellStart[cell] += mCellStart[cell - 1];
+
+	// Filling advances each cell's start to its end, shift them back afterwards
+	for (std::size_t i = 0; i < count; ++i)
+		mCellDrones[mCellStart[mDroneCells[i]]++] = i;
+
+	for (std::size_t cell = mCellStart.size() - 1; cell > 0; --cell)
+		mCellStart[cell] = mCellStart[cell - 1];
+	mCellStart[0] = 0;
+}
+
+void SwarmNode::gatherNeighbors()
+{
+	std::size_t count = mPositionX.size();
+	mCenterX.resize(count);
+	mCenterY.resize(count);
+	mHeadingX.resize(count);
+	mHeadingY.resize(count);
+	mSeparationX.resize(count);
+	mSeparationY.resize(count);
+
+	const float neighborRadiusSq = NeighborRadius * NeighborRadius;
+	const float separationRadiusSq = SeparationRadius * SeparationRadius;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		std::size_t column = mDroneCells[i] % mGridColumns;
+		std::size_t row = mDroneCells[i] / mGridColumns;
+
+		float sumX = 0.f, sumY = 0.f;
+		float headingX = 0.f, headingY = 0.f;
+		float separationX = 0.f, separationY = 0.f;
+		std::size_t neighbors = 0;
+
+		// The 3x3 block of cells around the drone contains everything within the neighbor radius
+		for (std::size_t r = (row > 0 ? row - 1 : 0); r <= std::min(row + 1, mGridRows - 1); ++r)
+		{
+			for (std::size_t c = (column > 0 ? column - 1 : 0); c <= std::min(column + 1, mGridColumns - 1); ++c)
+			{
+				std::size_t cell = r * mGridColumns + c;
+				for (std::size_t k = mCellStart[cell]; k < mCellStart[cell + 1]; ++k)
+				{
+					std::size_t j = mCellDrones[k];
+					if (j == i)
+						continue;
+
+					float dx = mPositionX[j] - mPositionX[i];
+					float dy = mPositionY[j] - mPositionY[i];
+					float distanceSq = dx * dx + dy * dy;
+					if (distanceSq >= neighborRadiusSq)
+						continue;
+
+					sumX += mPositionX[j];
+					sumY += mPositionY[j];
+					headingX += mVelocityX[j];
+					headingY += mVelocityY[j];
+					++neighbors;
+
+					// Push away from close neighbors, the harder the closer they are
+					if (distanceSq < separationRadiusSq && distanceSq > 0.f)
+					{
+						separationX -= dx / distanceSq;
+						separationY -= dy / distanceSq;
+					}
+				}
+			}
+		}
+
+		// Without neighbors the drone's own state makes cohesion and alignment neutral
+		if (neighbors > 0)
+		{
+			mCenterX[i] = sumX / neighbors;
+			mCenterY[i] = sumY / neighbors;
+			mHeadingX[i] = headingX / neighbors;
+			mHeadingY[i] = headingY / neighbors;
+		}
+		else
+		{
+			mCenterX[i] = mPositionX[i];
+			mCenterY[i] = mPositionY[i];
+			mHeadingX[i] = mVelocityX[i];
+			mHeadingY[i] = mVelocityY[i];
+		}
+
+		mSeparationX[i] = separationX;
+		mSeparationY[i] = separationY;
+	}
+}
+
+sf::Vector2f SwarmNode::getTarget() const
+{
+	// The whole swarm hunts the player closest to its first drone, or heads down the screen
+	sf::Vector2f lead(mPositionX[0], mPositionY[0]);
+	sf::Vector2f target = lead + sf::Vector2f(0.f, 1000.f);
+	float minDistance = std::numeric_limits<float>::max();
+
+	FOREACH(const Aircraft* player, mPlayers)
+	{
+		if (player->isDestroyed())
+			continue;
+
+		sf::Vector2f offset = player->getWorldPosition() - lead;
+		float distance = offset.x * offset.x + offset.y * offset.y;
+		if (distance < minDistance)
+		{
+			target = player->getWorldPosition();
+			minDistance = distance;
+		}
+	}
+
+	return target;
+}
+
+sf::FloatRect SwarmNode::getDroneRect(std::size_t index) const
+{
+	return sf::FloatRect(mPositionX[index] - DroneSize.x / 2.f, mPositionY[index] - DroneSize.y / 2.f, DroneSize.x, DroneSize.y);
+}
+
+void SwarmNode::removeDrone(std::size_t index)
+{
+	// Order doesn't matter, move the last drone into the gap
+	mPositionX[index] = mPositionX.back();
+	mPositionY[index] = mPositionY.back();
+	mVelocityX[index] = mVelocityX.back();
+	mVelocityY[index] = mVelocityY.back();
+	mHitpoints[index] = mHitpoints.back();
+
+	mPositionX.pop_back();
+	mPositionY.pop_back();
+	mVelocityX.pop_back();
+	mVelocityY.pop_back();
+	mHitpoints.pop_back();
+
+	mNeedsVertexUpdate = true;
+}
+
+void SwarmNode::computeVertices() const
+{
+	// Enemies face down the screen: the texture is mapped upside down, like their 180 degree rotation
+	const sf::IntRect& rect = Table[Aircraft::Raptor].textureRect;
+	float left = static_cast<float>(rect.left);
+	float top = static_cast<float>(rect.top);
+	float right = left + rect.width;
+	float bottom = top + rect.height;
+	sf::Vector2f half = DroneSize / 2.f;
+
+	mVertexArray.resize(4 * mPositionX.size());
+	for (std::size_t i = 0; i < mPositionX.size(); ++i)
+	{
+		sf::Vertex* quad = &mVertexArray[4 * i];
+		float x = mPositionX[i];
+		float y = mPositionY[i];
+
+		quad[0].position = sf::Vector2f(x - half.x, y - half.y);
+		quad[1].position = sf::Vector2f(x + half.x, y - half.y);
+		quad[2].position = sf::Vector2f(x + half.x, y + half.y);
+		quad[3].position = sf::Vector2f(x - half.x, y + half.y);
+
+		quad[0].texCoords = sf::Vector2f(right, bottom);
+		quad[1].texCoords = sf::Vector2f(left, bottom);
+		quad[2].texCoords = sf::Vector2f(left, top);
+		quad[3].texCoords = sf::Vector2f(right, top);
+	}
+}
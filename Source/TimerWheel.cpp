@@ -0,0 +1,217 @@
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace
+{
+	const std::size_t NoTimer = static_cast<std::size_t>(-1);
+
+	// Timers further away than the top wheel can represent are parked there and re-inserted on cascade
+	const TimerWheel::Tick MaxDelta = (TimerWheel::Tick(1) << 24) - 1;
+}
+
+const sf::Time TimerWheel::TickLength = sf::seconds(1.f / 60.f);
+
+TimerWheel::TimerWheel()
+: mTimers()
+, mFreeList()
+, mSlots()
+, mCurrentTick(0)
+, mAccumulatedTime(sf::Time::Zero)
+, mPendingCount(0)
+{
+	mSlots.fill(NoTimer);
+}
+
+TimerWheel::ID TimerWheel::schedule(sf::Time delay, Callback callback)
+{
+	return scheduleAt(mCurrentTick + toTicks(delay), std::move(callback));
+}
+
+TimerWheel::ID TimerWheel::scheduleAt(Tick tick, Callback callback)
+{
+	// Timers always fire in a future tick, never during the one being processed
+	tick = std::max(tick, mCurrentTick + 1);
+
+	std::size_t index;
+	if (!mFreeList.empty())
+	{
+		index = mFreeList.back();
+		mFreeList.pop_back();
+	}
+	else
+	{
+		index = mTimers.size();
+		mTimers.push_back(Timer());
+		mTimers[index].generation = 0;
+	}
+
+	Timer& timer = mTimers[index];
+	timer.callback = std::move(callback);
+	timer.expiry = tick;
+	timer.generation += 1;
+	insert(index);
+
+	++mPendingCount;
+	return (static_cast<ID>(timer.generation) << 32) | index;
+}
+
+void TimerWheel::cancel(ID id)
+{
+	if (!isPending(id))
+		return;
+
+	std::size_t index = static_cast<std::size_t>(id & 0xffffffff);
+	unlink(index);
+	release(index);
+}
+
+bool TimerWheel::isPending(ID id) const
+{
+	std::size_t index = static_cast<std::size_t>(id & 0xffffffff);
+	sf::Uint32 generation = static_cast<sf::Uint32>(id >> 32);
+
+	return id != InvalidID
+		&& index < mTimers.size()
+		&& mTimers[index].generation == generation
+		&& mTimers[index].slot != NoTimer;
+}
+
+TimerWheel::Tick TimerWheel::getRemainingTicks(ID id) const
+{
+	if (!isPending(id))
+		return 0;
+
+	return mTimers[static_cast<std::size_t>(id & 0xffffffff)].expiry - mCurrentTick;
+}
+
+void TimerWheel::update(sf::Time dt)
+{
+	mAccumulatedTime += dt;
+	while (mAccumulatedTime >= TickLength)
+	{
+		mAccumulatedTime -= TickLength;
+		advance();
+	}
+}
+
+void TimerWheel::advance()
+{
+	++mCurrentTick;
+
+	// Whenever a wheel wraps around, redistribute the next slot of the coarser wheel above it
+	for (std::size_t level = 1; level < LevelCount; ++level)
+	{
+		if ((mCurrentTick & ((Tick(1) << (level * LevelBits)) - 1)) != 0)
+			break;
+
+		cascade(level);
+	}
+
+	expire(static_cast<std::size_t>(mCurrentTick & (SlotsPerLevel - 1)));
+}
+
+TimerWheel::Tick TimerWheel::getCurrentTick() const
+{
+	return mCurrentTick;
+}
+
+sf::Time TimerWheel::getCurrentTime() const
+{
+	return sf::microseconds(TickLength.asMicroseconds() * static_cast<sf::Int64>(mCurrentTick));
+}
+
+std::size_t TimerWheel::getPendingCount() const
+{
+	return mPendingCount;
+}
+
+TimerWheel::Tick TimerWheel::toTicks(sf::Time time)
+{
+	float ticks = std::floor(time / TickLength + 0.5f);
+	return ticks < 1.f ? 1 : static_cast<Tick>(ticks);
+}
+
+void TimerWheel::insert(std::size_t index)
+{
+	Timer& timer = mTimers[index];
+	Tick delta = std::min(timer.expiry - mCurrentTick, MaxDelta);
+	Tick target = mCurrentTick + delta;
+
+	// Pick the finest wheel whose range still covers the remaining delay
+	std::size_t level = 0;
+	while (level + 1 < LevelCount && delta >= (Tick(1) << ((level + 1) * LevelBits)))
+		++level;
+
+	std::size_t slot = level * SlotsPerLevel + static_cast<std::size_t>((target >> (level * LevelBits)) & (SlotsPerLevel - 1));
+
+	timer.slot = slot;
+	timer.prev = NoTimer;
+	timer.next = mSlots[slot];
+	if (timer.next != NoTimer)
+		mTimers[timer.next].prev = index;
+	mSlots[slot] = index;
+}
+
+void TimerWheel::unlink(std::size_t index)
+{
+	Timer& timer = mTimers[index];
+	assert(timer.slot != NoTimer);
+
+	if (timer.prev != NoTimer)
+		mTimers[timer.prev].next = timer.next;
+	else
+		mSlots[timer.slot] = timer.next;
+
+	if (timer.next != NoTimer)
+		mTimers[timer.next].prev = timer.prev;
+
+	timer.slot = NoTimer;
+}
+
+void TimerWheel::release(std::size_t index)
+{
+	mTimers[index].callback = nullptr;
+	mFreeList.push_back(index);
+	--mPendingCount;
+}
+
+void TimerWheel::cascade(std::size_t level)
+{
+	std::size_t slot = level * SlotsPerLevel + static_cast<std::size_t>((mCurrentTick >> (level * LevelBits)) & (SlotsPerLevel - 1));
+
+	// Detach the whole list first, re-insertion may put timers back into the same slot
+	std::size_t index = mSlots[slot];
+	mSlots[slot] = NoTimer;
+
+	while (index != NoTimer)
+	{
+		std::size_t next = mTimers[index].next;
+		insert(index);
+		index = next;
+	}
+}
+
+void TimerWheel::expire(std::size_t slot)
+{
+	// Pop one timer at a time: callbacks are free to schedule or cancel other timers
+	while (mSlots[slot] != NoTimer)
+	{
+		std::size_t index = mSlots[slot];
+		unlink(index);
+
+		// Parked far-future timer that is not due yet
+		if (mTimers[index].expiry > mCurrentTick)
+		{
+			insert(index);
+			continue;
+		}
+
+		Callback callback = std::move(mTimers[index].callback);
+		release(index);
+		callback();
+	}
+}
@@ -8,8 +8,8 @@
 TitleState::TitleState(StateStack& stack, Context context)
 : State(stack, context)
 , mText()
-, mShowText(true)
-, mTextEffectTime(sf::Time::Zero)
+, mShowText(false)
+, mTimers()
 {
 	mBackgroundSprite.setTexture(context.textures->get(Textures::Welcome));
 
@@ -21,6 +21,7 @@ TitleState::TitleState(StateStack& stack, Context context)
 	context.music->setVolume(50.0f);
 	context.music->play(Music::Welcome);
 
+	toggleText();
 }
 
 void TitleState::draw()
@@ -34,17 +35,22 @@ void TitleState::draw()
 
 bool TitleState::update(sf::Time dt)
 {
-	mTextEffectTime += dt;
-
-	if (mTextEffectTime >= sf::seconds(0.88f))
-	{
-		mShowText = !mShowText;
-		mTextEffectTime = sf::Time::Zero;
-	}
+	mTimers.update(dt);
 
 	return true;
 }
 
+void TitleState::toggleText()
+{
+	mShowText = !mShowText;
+
+	// Blink "INSERT COIN" in a fixed rhythm
+	mTimers.schedule(sf::seconds(0.88f), [this] ()
+	{
+		toggleText();
+	});
+}
+
 bool TitleState::handleEvent(const sf::Event& event)
 {
 	// If any key is pressed, trigger the next screen
@@ -0,0 +1,217 @@
+#include "TrailNode.hpp"
+#include "DataTables.hpp"
+#include "Particle.hpp"
+#include "Foreach.hpp"
+#include "Utility.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+	const std::vector<ParticleData> Table = initializeParticleData();
+
+	// A new point is recorded at this interval, in between the newest one follows the missile
+	const sf::Time SampleInterval = sf::seconds(1.f / 15.f);
+	const sf::Time Lifetime = sf::seconds(1.f);
+
+	// The ribbon starts narrow and hot at the missile and widens into smoke as it ages
+	const float MinHalfWidth = 2.f;
+	const float MaxHalfWidth = 6.f;
+
+	// IDs carry the slot in the low bits and the slot's generation in the high bits
+	const sf::Uint32 SlotBits = 16;
+	const sf::Uint32 SlotMask = (1u << SlotBits) - 1u;
+
+	sf::Color mixColors(sf::Color from, sf::Color to, float ratio)
+	{
+		return sf::Color(
+			static_cast<sf::Uint8>(from.r + (to.r - from.r) * ratio),
+			static_cast<sf::Uint8>(from.g + (to.g - from.g) * ratio),
+			static_cast<sf::Uint8>(from.b + (to.b - from.b) * ratio),
+			static_cast<sf::Uint8>(255.f * (1.f - ratio)));
+	}
+}
+
+const TrailNode::ID TrailNode::InvalidID = 0xffffffff;
+
+TrailNode::TrailNode()
+: SceneNode()
+, mTrails()
+, mFreeSlots()
+, mElapsedTime(sf::Time::Zero)
+, mVertexArray(sf::TrianglesStrip)
+, mNeedsVertexUpdate(true)
+{
+}
+
+TrailNode::ID TrailNode::addTrail()
+{
+	std::size_t slot;
+	if (!mFreeSlots.empty())
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else
+	{
+		slot = mTrails.size();
+		mTrails.push_back(Trail());
+		mTrails[slot].generation = 0;
+	}
+
+	Trail& trail = mTrails[slot];
+	trail.head = 0;
+	trail.size = 0;
+	trail.addTime = mElapsedTime;
+	trail.isActive = true;
+
+	return static_cast<ID>(slot) | (trail.generation << SlotBits);
+}
+
+void TrailNode::extendTrail(ID id, sf::Vector2f position)
+{
+	if (!isLive(id))
+		return;
+
+	Trail& trail = mTrails[id & SlotMask];
+	std::size_t newest = (trail.head + trail.size + PointCount - 1) % PointCount;
+
+	if (trail.size == 0 || mElapsedTime - trail.times[newest] >= SampleInterval)
+	{
+		// Record a new point, dropping the oldest one when the ring is full
+		if (trail.size == PointCount)
+			trail.head = (trail.head + 1) % PointCount;
+		else
+			++trail.size;
+
+		newest = (trail.head + trail.size - 1) % PointCount;
+		trail.times[newest] = mElapsedTime;
+	}
+
+	trail.positions[newest] = position;
+	mNeedsVertexUpdate = true;
+}
+
+std::size_t TrailNode::getPointCount(ID id) const
+{
+	return isLive(id) ? mTrails[id & SlotMask].size : 0;
+}
+
+std::size_t TrailNode::getTrailCount() const
+{
+	return mTrails.size() - mFreeSlots.size();
+}
+
+unsigned int TrailNode::getCategory() const
+{
+	return Category::TrailSystem;
+}
+
+void TrailNode::translateOrigin(sf::Vector2f offset)
+{
+	// Trails are stored in world coordinates, the node itself stays at the origin
+	FOREACH(Trail& trail, mTrails)
+	{
+		FOREACH(sf::Vector2f& position, trail.positions)
+			position += offset;
+	}
+
+	mNeedsVertexUpdate = true;
+}
+
+void TrailNode::updateCurrent(sf::Time dt, CommandQueue&)
+{
+	mElapsedTime += dt;
+
+	for (std::size_t slot = 0; slot < mTrails.size(); ++slot)
+	{
+		Trail& trail = mTrails[slot];
+		if (!trail.isActive)
+			continue;
+
+		// Drop the points that faded out. A trail without any is done, unless it was added so recently
+		// that its missile had no update to record the first point yet
+		while (trail.size > 0 && mElapsedTime - trail.times[trail.head] >= Lifetime)
+		{
+			trail.head = (trail.head + 1) % PointCount;
+			--trail.size;
+		}
+
+		if (trail.size == 0 && mElapsedTime - trail.addTime >= Lifetime)
+		{
+			trail.isActive = false;
+			trail.generation = (trail.generation + 1) & SlotMask;
+			mFreeSlots.push_back(slot);
+		}
+	}
+
+	mNeedsVertexUpdate = true;
+}
+
+void TrailNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if (mNeedsVertexUpdate)
+	{
+		computeVertices();
+		mNeedsVertexUpdate = false;
+	}
+
+	target.draw(mVertexArray, states);
+}
+
+bool TrailNode::isLive(ID id) const
+{
+	// A trail that faded out while nobody fed it may belong to another missile by now
+	std::size_t slot = id & SlotMask;
+	return id != InvalidID && slot < mTrails.size() && mTrails[slot].generation == (id >> SlotBits) && mTrails[slot].isActive;
+}
+
+void TrailNode::computeVertices() const
+{
+	mVertexArray.clear();
+
+	FOREACH(const Trail& trail, mTrails)
+	{
+		if (trail.isActive && trail.size >= 2)
+			appendRibbon(trail);
+	}
+}
+
+void TrailNode::appendRibbon(const Trail& trail) const
+{
+	const sf::Color& hot = Table[Particle::Propellant].color;
+	const sf::Color& smoke = Table[Particle::Smoke].color;
+
+	for (std::size_t i = 0; i < trail.size; ++i)
+	{
+		std::size_t index = (trail.head + i) % PointCount;
+		std::size_t previous = (trail.head + (i > 0 ? i - 1 : i)) % PointCount;
+		std::size_t next = (trail.head + (i + 1 < trail.size ? i + 1 : i)) % PointCount;
+
+		// The ribbon is extruded sideways from the direction between the neighbouring points
+		sf::Vector2f direction = trail.positions[next] - trail.positions[previous];
+		if (length(direction) > 0.f)
+			direction = unitVector(direction);
+
+		float ratio = std::min((mElapsedTime - trail.times[index]).asSeconds() / Lifetime.asSeconds(), 1.f);
+		sf::Vector2f side = sf::Vector2f(-direction.y, direction.x) * (MinHalfWidth + (MaxHalfWidth - MinHalfWidth) * ratio);
+		sf::Color color = mixColors(hot, smoke, ratio);
+
+		sf::Vertex left(trail.positions[index] + side, color);
+		sf::Vertex right(trail.positions[index] - side, color);
+
+		// Repeating the first and last vertex joins the ribbons with triangles that have no area
+		if (i == 0 && mVertexArray.getVertexCount() > 0)
+			mVertexArray.append(left);
+
+		mVertexArray.append(left);
+		mVertexArray.append(right);
+
+		if (i + 1 == trail.size)
+			mVertexArray.append(right);
+	}
+}
@@ -1,5 +1,4 @@
 #include "Utility.hpp"
-#include "Animation.hpp"
 
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Text.hpp>
@@ -146,12 +145,6 @@ void centerOrigin(sf::Text& text)
 	text.setOrigin(std::floor(bounds.left + bounds.width / 2.f), std::floor(bounds.top + bounds.height / 2.f));
 }
 
-void centerOrigin(Animation& animation)
-{
-	sf::FloatRect bounds = animation.getLocalBounds();
-	animation.setOrigin(std::floor(bounds.left + bounds.width / 2.f), std::floor(bounds.top + bounds.height / 2.f));
-}
-
 float toDegree(float radian)
 {
 	return 180.f / 3.141592653589793238462643383f * radian;
@@ -162,6 +155,12 @@ float toRadian(float degree)
 	return 3.141592653589793238462643383f / 180.f * degree;
 }
 
+std::default_random_engine& getRandomEngine()
+{
+	// Exposed so that the simulation can seed, save and restore it
+	return RandomEngine;
+}
+
 int randomInt(int exclusiveMax)
 {
 	std::uniform_int_distribution<> distr(0, exclusiveMax - 1);
@@ -0,0 +1,69 @@
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+
+namespace
+{
+	// More threads than this don't pay off for the per-frame loops of the game
+	const std::size_t MaxThreadCount = 7;
+}
+
+WorkerPool::WorkerPool(std::size_t threadCount)
+: mThreads()
+, mTask(nullptr)
+, mCount(0)
+, mChunkSize(0)
+{
+	// Chunk 0 belongs to the calling thread, worker i takes chunk i + 1
+	for (std::size_t i = 0; i < threadCount; ++i)
+		mThreads.push_back(std::unique_ptr<sf::Thread>(new sf::Thread(std::bind(&WorkerPool::runChunk, this, i + 1))));
+}
+
+void WorkerPool::run(std::size_t count, std::size_t minChunkSize, const Task& task)
+{
+	// One chunk per thread, but none smaller than the given size
+	std::size_t chunkCount = std::min(mThreads.size() + 1, count / std::max<std::size_t>(minChunkSize, 1));
+	if (chunkCount <= 1)
+	{
+		if (count > 0)
+			task(0, count);
+		return;
+	}
+
+	mTask = &task;
+	mCount = count;
+	mChunkSize = (count + chunkCount - 1) / chunkCount;
+
+	for (std::size_t i = 0; i + 1 < chunkCount; ++i)
+		mThreads[i]->launch();
+
+	runChunk(0);
+
+	for (std::size_t i = 0; i + 1 < chunkCount; ++i)
+		mThreads[i]->wait();
+
+	mTask = nullptr;
+}
+
+std::size_t WorkerPool::getThreadCount() const
+{
+	return mThreads.size();
+}
+
+std::size_t WorkerPool::getDefaultThreadCount()
+{
+	// The calling thread works as well, so one core is left out. A single core gets no workers at all
+	std::size_t cores = std::thread::hardware_concurrency();
+	return std::min(cores > 1 ? cores - 1 : 0, MaxThreadCount);
+}
+
+void WorkerPool::runChunk(std::size_t chunk)
+{
+	std::size_t begin = std::min(chunk * mChunkSize, mCount);
+	std::size_t end = std::min(begin + mChunkSize, mCount);
+
+	if (begin < end)
+		(*mTask)(begin, end);
+}
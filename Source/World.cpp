@@ -4,8 +4,17 @@
 #include "Foreach.hpp"
 #include "TextNode.hpp"
 #include "ParticleNode.hpp"
+#include "ExplosionNode.hpp"
+#include "TrailNode.hpp"
 #include "SoundNode.hpp"
+#include "Snapshot.hpp"
+#include "FormationNode.hpp"
+#include "BulletNode.hpp"
+#include "SwarmNode.hpp"
+#include "Utility.hpp"
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/System/Clock.hpp>
 
 
 #include <algorithm>
@@ -13,30 +22,128 @@
 #include <limits>
 
 
-World::World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sounds)
+namespace
+{
+	// Height of the strip above the view where enemies spawn; they are simulated in lower
+	// detail until they come within half of it and at full detail once they touch the view
+	const float SpawnMargin = 100.f;
+
+	// How far the view may scroll away from the origin before all coordinates are shifted back
+	const float RebaseDistance = 2048.f;
+
+	// Enemies this many screens ahead of the view are built in the background
+	const float PrefetchScreens = 3.f;
+
+	// Horizontal distance between the starting positions of two players
+	const float PlayerSpacing = 100.f;
+
+	// Split screen gives each of the two players a vertical strip of the screen
+	const std::size_t SplitViewCount = 2;
+	const float DividerWidth = 4.f;
+
+	// Scene nodes that aren't entities sort before all entities, formations sort like their leader
+	sf::Uint32 entityId(const SceneNode& node)
+	{
+		if (const FormationNode* formation = dynamic_cast<const FormationNode*>(&node))
+			return formation->getId();
+
+		const Entity* entity = dynamic_cast<const Entity*>(&node);
+		return entity ? entity->getEntityId() : 0;
+	}
+
+	bool hasSmallerEntityId(const SceneNode& lhs, const SceneNode& rhs)
+	{
+		return entityId(lhs) < entityId(rhs);
+	}
+
+	// Enemies of one kind placed side by side fly as a formation
+	bool isSameFormation(const LevelFormat::Spawn& lhs, const LevelFormat::Spawn& rhs)
+	{
+		return lhs.distance == rhs.distance && lhs.type == rhs.type && lhs.pattern == rhs.pattern;
+	}
+
+	bool hasSmallerId(const EntityState& lhs, const EntityState& rhs)
+	{
+		return lhs.id < rhs.id;
+	}
+
+	bool containsEntity(const WorldSnapshot& snapshot, sf::Uint32 id)
+	{
+		EntityState key;
+		key.id = id;
+
+		return std::binary_search(snapshot.entities.begin(), snapshot.entities.end(), key, &hasSmallerId);
+	}
+
+	float distanceToRect(sf::Vector2f point, const sf::FloatRect& rect)
+	{
+		float dx = std::max(std::max(rect.left - point.x, point.x - (rect.left + rect.width)), 0.f);
+		float dy = std::max(std::max(rect.top - point.y, point.y - (rect.top + rect.height)), 0.f);
+
+		return std::sqrt(dx * dx + dy * dy);
+	}
+}
+
+World::World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sounds, Mode mode, unsigned long seed)
 	: mTarget(outputTarget)
 	, mSceneTexture()
 	, mWorldView(outputTarget.getDefaultView())
+	, mSplitScreen(false)
+	, mViews()
+	, mViewRects()
+	, mDrawLists()
 	, mTextures()
+	, mShaders()
+	, mAnimations()
+	, mSpriteBatch()
 	, mFonts(fonts)
 	, mSounds(sounds)
+	, mWorkers()
+	, mParticleBudget()
+	, mParticleSystems()
+	, mFrameWorkTime(sf::Time::Zero)
+	, mTimers()
+	, mBehaviors(mTimers, mPlayerAircrafts)
+	, mEnemyPool(mTextures, fonts, mTimers, mBehaviors, mParticleSystems)
 	, mSceneGraph()
 	, mSceneLayers()
 	, mWorldBounds(0.f, 0.f, mWorldView.getSize().x, 10000.f)
 	, mSpawnPosition(mWorldView.getSize().x / 2.f, mWorldBounds.height - mWorldView.getSize().y / 2.f)
 	, mScrollSpeed(mLevel == 1 ? -100.f : (mLevel == 2 ? -125.f : (mLevel == 3 ? -125.f : (mLevel == 4 ? -150.f : -150.f))))
-	, mPlayerAircraft(nullptr)
-	, mEnemySpawnPoints()
+	, mPlayerAircrafts()
+	, mPlayerExplosionTime(sf::Time::Zero)
+	, mOriginOffset(0.0)
+	, mMode(mode)
+	, mLevelData()
+	, mGenerator(seed)
+	, mChunkSpawns()
+	, mChunkIndex(0)
+	, mChunkOrigin()
+	, mNextSpawnPoint(0)
+	, mPrefetchPoint(0)
+	, mBackground(nullptr)
+	, mBackgroundTileHeight(0.f)
+	, mBullets(nullptr)
+	, mExplosions(nullptr)
 	, mActiveEnemies()
+	, mFormations()
+	, mColliders()
+	, mWrecks()
 {
 	mSceneTexture.create(mTarget.getSize().x, mTarget.getSize().y);
 
+	// Every world numbers its entities from the start, so that two peers agree on them
+	Entity::setNextEntityId(1);
 
 	loadTextures();
 	buildScene();
 
 	// Prepare the view
 	mWorldView.setCenter(mSpawnPosition);
+
+	// The enemies of the first screens are built while loading, the pool's worker thread keeps ahead from there on
+	prefetchEnemies();
+	mEnemyPool.prewarm();
 }
 
 int World::mLevel = 1;
@@ -44,13 +151,18 @@ long long int World::mScore = 0;
 
 void World::update(sf::Time dt)
 {
+	// The time spent here and in draw() drives the particle budget
+	sf::Clock workClock;
+
 	// Scroll the world, reset player velocity
 	mWorldView.move(0.f, mScrollSpeed * dt.asSeconds());
-	mPlayerAircraft->setVelocity(0.f, 0.f);
+	FOREACH(Aircraft* aircraft, mPlayerAircrafts)
+		aircraft->setVelocity(0.f, 0.f);
 	
 	// Setup commands to destroy entities, and guide missiles
 	destroyEntitiesOutsideView();
 	guideMissiles();
+	updateDetailLevels();
 
 	// Forward commands to scene graph, adapt velocity (scrolling, diagonal correction)
 	while (!mCommandQueue.isEmpty())
@@ -60,36 +172,73 @@ void World::update(sf::Time dt)
 	// Collision detection and response (may destroy entities)
 	handleCollisions();
 
-	// Remove all destroyed entities, create new ones
-	mSceneGraph.removeWrecks();
+	// Break up formations that lost their leader, remove all destroyed entities, create new ones
+	updateFormations();
+	removePlayerWrecks(dt);
+	removeWrecks();
+	prefetchEnemies();
 	spawnEnemies();
 
-	// Regular update step, adapt position (correct if outside view)
+	// Fire due timers, then the regular update step, adapt position (correct if outside view)
+	mTimers.update(dt);
 	mSceneGraph.update(dt, mCommandQueue);
 	adaptPlayerPosition();
 
+	// Execute the commands of the update step right away, so that no state is left in the queue between ticks
+	while (!mCommandQueue.isEmpty())
+		mSceneGraph.onCommand(mCommandQueue.pop(), dt);
+
+	if (mMode == Endless)
+		scrollBackground();
 
 	updateSounds();
+	rebaseOrigin();
+
+	mParticleBudget.setViewBounds(getViewBounds());
+	mFrameWorkTime += workClock.getElapsedTime();
 }
 
 void World::draw()
 {
+	sf::Clock workClock;
 
+	// Cull the scene graph once for all views, instead of traversing it once per view
+	updateViews();
+	mSceneGraph.collectDrawLists(mViewRects, mDrawLists);
 
 	if (PostEffect::isSupported())
 	{
-
+		// All views share one scene texture, so bloom runs a single time
 		mSceneTexture.clear();
-		mSceneTexture.setView(mWorldView);
-		mSceneTexture.draw(mSceneGraph);
+		drawViews(mSceneTexture);
 		mSceneTexture.display();
 		mBloomEffect.apply(mSceneTexture, mTarget);
 	}
 	else
 	{
-		mTarget.setView(mWorldView);
-		mTarget.draw(mSceneGraph);
+		drawViews(mTarget);
 	}
+
+	if (mSplitScreen)
+	{
+		sf::Vector2f targetSize(mTarget.getSize());
+
+		sf::RectangleShape divider(sf::Vector2f(DividerWidth, targetSize.y));
+		divider.setFillColor(sf::Color::Black);
+		divider.setPosition((targetSize.x - DividerWidth) / 2.f, 0.f);
+
+		mTarget.setView(mTarget.getDefaultView());
+		mTarget.draw(divider);
+	}
+
+	// All updates since the last frame plus this draw make up the frame's cost
+	mParticleBudget.setFrameTime(mFrameWorkTime + workClock.getElapsedTime());
+	mFrameWorkTime = sf::Time::Zero;
+}
+
+void World::setSplitScreen(bool enabled)
+{
+	mSplitScreen = enabled;
 }
 
 CommandQueue& World::getCommandQueue()
@@ -97,14 +246,235 @@ CommandQueue& World::getCommandQueue()
 	return mCommandQueue;
 }
 
+TimerWheel& World::getTimers()
+{
+	return mTimers;
+}
+
+Aircraft* World::addAircraft(int identifier)
+{
+	std::unique_ptr<Aircraft> player(new Aircraft(Aircraft::Eagle, mTextures, mFonts, mTimers, mBehaviors, mParticleSystems));
+	player->setPosition(mSpawnPosition.x + PlayerSpacing * (identifier - 1), mSpawnPosition.y);
+	player->setIdentifier(identifier);
+
+	mPlayerAircrafts.push_back(player.get());
+	mSceneLayers[UpperAir]->attachChild(std::move(player));
+
+	return mPlayerAircrafts.back();
+}
+
+Aircraft* World::getAircraft(int identifier) const
+{
+	FOREACH(Aircraft* aircraft, mPlayerAircrafts)
+	{
+		if (aircraft->getIdentifier() == identifier)
+			return aircraft;
+	}
+
+	return nullptr;
+}
+
+void World::saveState(WorldSnapshot& snapshot)
+{
+	snapshot.originOffset = mOriginOffset;
+	snapshot.viewCenter = mWorldView.getCenter();
+	snapshot.spawnChunk = mChunkIndex;
+	snapshot.chunkOrigin = mChunkOrigin;
+	snapshot.nextSpawnPoint = mNextSpawnPoint;
+	snapshot.nextEntityId = Entity::getNextEntityId();
+	snapshot.score = mScore;
+	snapshot.playerExplosionTime = mPlayerExplosionTime;
+	snapshot.randomEngine = getRandomEngine();
+
+	// Reuse the entity array, a snapshot is taken every tick
+	snapshot.entities.clear();
+
+	Command collector;
+	collector.category = Category::Aircraft | Category::Projectile | Category::Pickup;
+	collector.action = derivedAction<Entity>([&snapshot] (Entity& entity, sf::Time)
+	{
+		snapshot.entities.push_back(EntityState());
+		entity.saveState(snapshot.entities.back());
+	});
+
+	mSceneGraph.onCommand(collector, sf::Time::Zero);
+	std::sort(snapshot.entities.begin(), snapshot.entities.end(), &hasSmallerId);
+
+	mBullets->saveState(snapshot.bullets, snapshot.nextBulletId);
+	mExplosions->saveState(snapshot.explosions);
+
+	// Swarms in scene order, they are recreated in the same order
+	snapshot.swarms.clear();
+
+	Command swarmCollector;
+	swarmCollector.category = Category::Swarm;
+	swarmCollector.action = derivedAction<SwarmNode>([&snapshot] (SwarmNode& swarm, sf::Time)
+	{
+		snapshot.swarms.push_back(SwarmState());
+		swarm.saveState(snapshot.swarms.back());
+	});
+
+	mSceneGraph.onCommand(swarmCollector, sf::Time::Zero);
+
+	snapshot.formations.resize(mFormations.size());
+	for (std::size_t i = 0; i < mFormations.size(); ++i)
+		mFormations[i]->saveState(snapshot.formations[i]);
+}
+
+void World::loadState(const WorldSnapshot& snapshot)
+{
+	// Shift the world back to the origin the snapshot was taken in
+	translateWorld(sf::Vector2f(0.f, static_cast<float>(snapshot.originOffset - mOriginOffset)));
+
+	// Formations are rebuilt from the snapshot, until then their members sit in the layer
+	FOREACH(FormationNode* formation, mFormations)
+	{
+		formation->release(*mSceneLayers[UpperAir]);
+		mSceneLayers[UpperAir]->detachChild(*formation);
+	}
+	mFormations.clear();
+
+	mBullets->loadState(snapshot.bullets, snapshot.nextBulletId);
+	mExplosions->loadState(snapshot.explosions);
+
+	// Swarms have no identity of their own, they are simply replaced by the saved ones
+	std::vector<SwarmNode*> swarms;
+
+	Command swarmCollector;
+	swarmCollector.category = Category::Swarm;
+	swarmCollector.action = derivedAction<SwarmNode>([&swarms] (SwarmNode& swarm, sf::Time)
+	{
+		swarms.push_back(&swarm);
+	});
+
+	mSceneGraph.onCommand(swarmCollector, sf::Time::Zero);
+	FOREACH(SwarmNode* swarm, swarms)
+		mSceneLayers[UpperAir]->detachChild(*swarm);
+
+	FOREACH(const SwarmState& state, snapshot.swarms)
+	{
+		std::unique_ptr<SwarmNode> swarm(new SwarmNode(mTextures, mPlayerAircrafts));
+		swarm->loadState(state);
+		mSceneLayers[UpperAir]->attachChild(std::move(swarm));
+	}
+
+	// Remove the entities that didn't exist back then
+	Command remover;
+	remover.category = Category::Aircraft | Category::Projectile | Category::Pickup;
+	remover.action = derivedAction<Entity>([&snapshot] (Entity& entity, sf::Time)
+	{
+		if (!containsEntity(snapshot, entity.getEntityId()))
+			entity.remove();
+	});
+
+	mSceneGraph.onCommand(remover, sf::Time::Zero);
+	removePlayerWrecks(sf::Time::Zero);
+	removeWrecks();
+
+	// Restore the remaining entities in place, recreate the ones removed in the meantime
+	std::vector<Entity*> entities;
+	std::vector<Aircraft*> members;
+	entities.reserve(snapshot.entities.size());
+
+	Command collector;
+	collector.category = remover.category;
+	collector.action = derivedAction<Entity>([&entities] (Entity& entity, sf::Time)
+	{
+		entities.push_back(&entity);
+	});
+
+	mSceneGraph.onCommand(collector, sf::Time::Zero);
+	std::sort(entities.begin(), entities.end(), [] (Entity* lhs, Entity* rhs)
+	{
+		return lhs->getEntityId() < rhs->getEntityId();
+	});
+
+	FOREACH(const EntityState& state, snapshot.entities)
+	{
+		auto found = std::lower_bound(entities.begin(), entities.end(), state.id, [] (Entity* entity, sf::Uint32 id)
+		{
+			return entity->getEntityId() < id;
+		});
+
+		Entity* entity = (found != entities.end() && (*found)->getEntityId() == state.id) ? *found : createEntity(state);
+		entity->loadState(state);
+
+		if (state.formation != 0)
+			members.push_back(static_cast<Aircraft*>(entity));
+	}
+
+	// Put the members back into their formations, with the offsets they were saved with
+	FOREACH(const FormationState& state, snapshot.formations)
+	{
+		std::unique_ptr<FormationNode> formation(new FormationNode(state));
+		mFormations.push_back(formation.get());
+		mSceneLayers[UpperAir]->attachChild(std::move(formation));
+	}
+
+	FOREACH(Aircraft* member, members)
+	{
+		auto formation = std::find_if(mFormations.begin(), mFormations.end(), [member] (FormationNode* f)
+		{
+			return f->getId() == member->getFormation();
+		});
+
+		// A member whose formation is missing from the snapshot keeps flying on its own
+		if (formation == mFormations.end())
+			member->setFormation(0);
+		else
+			(*formation)->attachChild(mSceneLayers[UpperAir]->detachChild(*member));
+	}
+
+	// Entities are updated in the order they were created in, which also decides the IDs of new entities
+	mSceneLayers[LowerAir]->sortChildren(&hasSmallerEntityId);
+	mSceneLayers[UpperAir]->sortChildren(&hasSmallerEntityId);
+
+	Entity::setNextEntityId(snapshot.nextEntityId);
+	mWorldView.setCenter(snapshot.viewCenter);
+	// Chunks depend on their index alone, so a retired one is simply generated again
+	if (mMode == Endless && mChunkIndex != snapshot.spawnChunk)
+		startChunk(snapshot.spawnChunk);
+
+	mChunkOrigin = snapshot.chunkOrigin;
+	mNextSpawnPoint = snapshot.nextSpawnPoint;
+	mScore = snapshot.score;
+	mPlayerExplosionTime = snapshot.playerExplosionTime;
+
+	// The reservations ahead are made again from the restored spawn point
+	mEnemyPool.clearReservations();
+	mPrefetchPoint = mNextSpawnPoint;
+	getRandomEngine() = snapshot.randomEngine;
+}
+
+unsigned long World::getSeed() const
+{
+	return mGenerator.getSeed();
+}
+
 bool World::hasAlivePlayer() const
 {
-	return !mPlayerAircraft->isMarkedForRemoval();
+	FOREACH(Aircraft* aircraft, mPlayerAircrafts)
+	{
+		if (!aircraft->isMarkedForRemoval())
+			return true;
+	}
+
+	// The last player counts as alive until its explosion has played
+	return mPlayerExplosionTime > sf::Time::Zero;
 }
 
 bool World::hasPlayerReachedEnd() const
 {
-	return !mWorldBounds.contains(mPlayerAircraft->getPosition());
+	if (mMode == Endless)
+		return false;
+
+	FOREACH(Aircraft* aircraft, mPlayerAircrafts)
+	{
+		if (!mWorldBounds.contains(aircraft->getPosition()))
+			return true;
+	}
+
+	return false;
 }
 
 void World::loadTextures()
@@ -117,6 +487,14 @@ void World::loadTextures()
 	mTextures.load(Textures::Explosion, "Media/Textures/Explosion.png");
 	mTextures.load(Textures::Particle, "Media/Textures/Particle.png");
 	mTextures.load(Textures::FinishLine, "Media/Textures/FinishLine.png");
+
+	// Clips are built once, every animation playing one only keeps its start
+	std::unique_ptr<AnimationClip> explosion(new AnimationClip(mTextures.get(Textures::Explosion), sf::Vector2i(256, 256), 16, sf::seconds(1), false));
+	mAnimations.insert(Animations::Explosion, std::move(explosion));
+
+	// Particles fade out on the GPU where shaders are available
+	if (sf::Shader::isAvailable())
+		mShaders.load(Shaders::ParticlePass, "Media/Shaders/Particle.vert", "Media/Shaders/Particle.frag");
 }
 
 void World::adaptPlayerPosition()
@@ -125,24 +503,30 @@ void World::adaptPlayerPosition()
 	sf::FloatRect viewBounds = getViewBounds();
 	const float borderDistance = 40.f;
 
-	sf::Vector2f position = mPlayerAircraft->getPosition();
-	position.x = std::max(position.x, viewBounds.left + borderDistance);
-	position.x = std::min(position.x, viewBounds.left + viewBounds.width - borderDistance);
-	position.y = std::max(position.y, viewBounds.top + borderDistance);
-	position.y = std::min(position.y, viewBounds.top + viewBounds.height - borderDistance);
-	mPlayerAircraft->setPosition(position);
+	FOREACH(Aircraft* aircraft, mPlayerAircrafts)
+	{
+		sf::Vector2f position = aircraft->getPosition();
+		position.x = std::max(position.x, viewBounds.left + borderDistance);
+		position.x = std::min(position.x, viewBounds.left + viewBounds.width - borderDistance);
+		position.y = std::max(position.y, viewBounds.top + borderDistance);
+		position.y = std::min(position.y, viewBounds.top + viewBounds.height - borderDistance);
+		aircraft->setPosition(position);
+	}
 }
 
 void World::adaptPlayerVelocity()
 {
-	sf::Vector2f velocity = mPlayerAircraft->getVelocity();
+	FOREACH(Aircraft* aircraft, mPlayerAircrafts)
+	{
+		sf::Vector2f velocity = aircraft->getVelocity();
 
-	// If moving diagonally, reduce velocity (to have always same velocity)
-	if (velocity.x != 0.f && velocity.y != 0.f)
-		mPlayerAircraft->setVelocity(velocity / std::sqrt(2.f));
+		// If moving diagonally, reduce velocity (to have always same velocity)
+		if (velocity.x != 0.f && velocity.y != 0.f)
+			aircraft->setVelocity(velocity / std::sqrt(2.f));
 
-	// Add scrolling velocity
-	mPlayerAircraft->accelerate(0.f, mScrollSpeed);
+		// Add scrolling velocity
+		aircraft->accelerate(0.f, mScrollSpeed);
+	}
 }
 
 bool matchesCategories(SceneNode::Pair& colliders, Category::Type type1, Category::Type type2)
@@ -168,8 +552,37 @@ bool matchesCategories(SceneNode::Pair& colliders, Category::Type type1, Categor
 
 void World::handleCollisions()
 {
-	std::set<SceneNode::Pair> collisionPairs;
-	mSceneGraph.checkSceneCollision(mSceneGraph, collisionPairs);
+	// Gather the bounding rectangles of all living entities once
+	mColliders.clear();
+
+	Command collector;
+	collector.category = Category::Aircraft | Category::Projectile | Category::Pickup;
+	collector.action = [this] (SceneNode& node, sf::Time)
+	{
+		if (!node.isDestroyed())
+			mColliders.push_back(Collider(&node, node.getBoundingRect()));
+	};
+
+	mSceneGraph.onCommand(collector, sf::Time::Zero);
+
+	// Sweep along the x axis: only rectangles overlapping there can collide. Unlike a std::set of
+	// node pointers, the resulting order only depends on the positions, the same on every machine
+	std::stable_sort(mColliders.begin(), mColliders.end(), [] (const Collider& lhs, const Collider& rhs)
+	{
+		return lhs.bounds.left < rhs.bounds.left;
+	});
+
+	std::vector<SceneNode::Pair> collisionPairs;
+	for (std::size_t i = 0; i < mColliders.size(); ++i)
+	{
+		float right = mColliders[i].bounds.left + mColliders[i].bounds.width;
+
+		for (std::size_t j = i + 1; j < mColliders.size() && mColliders[j].bounds.left <= right; ++j)
+		{
+			if (mColliders[i].bounds.intersects(mColliders[j].bounds))
+				collisionPairs.push_back(SceneNode::Pair(mColliders[i].node, mColliders[j].node));
+		}
+	}
 
 	FOREACH(SceneNode::Pair pair, collisionPairs)
 	{
@@ -213,17 +626,201 @@ void World::handleCollisions()
 			}
 		}
 	}
+
+	// Swarms test their drones against the allied bullets and the players themselves
+	Command swarmCollider;
+	swarmCollider.category = Category::Swarm;
+	swarmCollider.action = derivedAction<SwarmNode>([this] (SwarmNode& swarm, sf::Time)
+	{
+		mScore += 2 * static_cast<long long int>(swarm.handleCollisions(*mBullets));
+	});
+
+	mSceneGraph.onCommand(swarmCollider, sf::Time::Zero);
+
+	// Bullets aren't scene nodes, each aircraft is tested against the other side's bullets in one pass
+	FOREACH(const Collider& collider, mColliders)
+	{
+		if (!(collider.node->getCategory() & Category::Aircraft) || collider.node->isDestroyed())
+			continue;
+
+		auto& aircraft = static_cast<Aircraft&>(*collider.node);
+		int damage = mBullets->removeHits(aircraft.isAllied() ? BulletNode::Enemy : BulletNode::Allied, collider.bounds);
+		if (damage == 0)
+			continue;
+
+		aircraft.damage(damage);
+		if (aircraft.isDestroyed())
+		{
+			if (aircraft.getType() == Aircraft::Avenger) mScore += 50;
+			else if (aircraft.getType() == Aircraft::Raptor) mScore += 10;
+		}
+	}
 }
 
 void World::updateSounds()
 {
-	// Set listener's position to player position
-	mSounds.setListenerPosition(mPlayerAircraft->getWorldPosition());
+	// Set listener's position to the players' center, follow the view once they are gone
+	sf::Vector2f listenerPosition = mWorldView.getCenter();
+	if (!mPlayerAircrafts.empty())
+	{
+		listenerPosition = sf::Vector2f();
+		FOREACH(Aircraft* aircraft, mPlayerAircrafts)
+			listenerPosition += aircraft->getWorldPosition();
+
+		listenerPosition /= static_cast<float>(mPlayerAircrafts.size());
+	}
+
+	mSounds.setListenerPosition(listenerPosition);
 
 	// Remove unused sounds
 	mSounds.removeStoppedSounds();
 }
 
+void World::updateViews()
+{
+	if (!mSplitScreen)
+	{
+		mViews.assign(1, mWorldView);
+	}
+	else
+	{
+		// The strips scroll along with the world view, and follow their player sideways
+		sf::Vector2f size(mWorldView.getSize().x / SplitViewCount, mWorldView.getSize().y);
+		float minX = mWorldBounds.left + size.x / 2.f;
+		float maxX = mWorldBounds.left + mWorldBounds.width - size.x / 2.f;
+
+		mViews.resize(SplitViewCount);
+		for (std::size_t i = 0; i < SplitViewCount; ++i)
+		{
+			sf::View& view = mViews[i];
+
+			// A view stays where its player was shot down
+			float centerX = view.getCenter().x;
+			if (Aircraft* aircraft = getAircraft(static_cast<int>(i) + 1))
+				centerX = aircraft->getWorldPosition().x;
+
+			view.setSize(size);
+			view.setCenter(std::max(minX, std::min(centerX, maxX)), mWorldView.getCenter().y);
+			view.setViewport(sf::FloatRect(static_cast<float>(i) / SplitViewCount, 0.f, 1.f / SplitViewCount, 1.f));
+		}
+	}
+
+	mViewRects.resize(mViews.size());
+	for (std::size_t i = 0; i < mViews.size(); ++i)
+		mViewRects[i] = sf::FloatRect(mViews[i].getCenter() - mViews[i].getSize() / 2.f, mViews[i].getSize());
+}
+
+void World::drawViews(sf::RenderTarget& target)
+{
+	for (std::size_t i = 0; i < mViews.size(); ++i)
+	{
+		target.setView(mViews[i]);
+		SceneNode::drawList(mDrawLists[i], target, mSpriteBatch);
+	}
+}
+
+void World::rebaseOrigin()
+{
+	// Floats lose precision far from zero, so keep the view close to the origin by shifting the world
+	sf::Vector2f center = mWorldView.getCenter();
+	if (std::abs(center.y) < RebaseDistance)
+		return;
+
+	// Whole units, so that shifted positions stay exact
+	translateWorld(sf::Vector2f(0.f, -std::floor(center.y)));
+}
+
+void World::translateWorld(sf::Vector2f offset)
+{
+	mOriginOffset += offset.y;
+
+	mWorldView.move(offset);
+	mWorldBounds.top += offset.y;
+	mSpawnPosition += offset;
+	mChunkOrigin += offset;
+
+	// Only top-level entities move, everything below them is relative
+	FOREACH(SceneNode* layer, mSceneLayers)
+		layer->translateChildren(offset);
+
+	mSounds.translateSounds(offset);
+	mSounds.setListenerPosition(mSounds.getListenerPosition() + offset);
+}
+
+void World::removePlayerWrecks(sf::Time dt)
+{
+	mPlayerExplosionTime = std::max(mPlayerExplosionTime - dt, sf::Time::Zero);
+
+	// A shot down player's explosion plays on in the ExplosionNode
+	FOREACH(Aircraft* aircraft, mPlayerAircrafts)
+	{
+		if (aircraft->hasExploded())
+			mPlayerExplosionTime = mAnimations.get(Animations::Explosion).getDuration();
+	}
+
+	// Forget the players' aircraft before the scene graph deletes them
+	auto wreckBegin = std::remove_if(mPlayerAircrafts.begin(), mPlayerAircrafts.end(), std::mem_fn(&Aircraft::isMarkedForRemoval));
+	mPlayerAircrafts.erase(wreckBegin, mPlayerAircrafts.end());
+}
+
+void World::removeWrecks()
+{
+	// Enemy aircraft go back to the pool, all other wrecks are deleted
+	mSceneGraph.removeWrecks(mWrecks);
+
+	FOREACH(SceneNode::Ptr& wreck, mWrecks)
+	{
+		Aircraft* aircraft = dynamic_cast<Aircraft*>(wreck.get());
+		if (aircraft && !aircraft->isAllied())
+		{
+			wreck.release();
+			mEnemyPool.release(std::unique_ptr<Aircraft>(aircraft));
+		}
+	}
+
+	mWrecks.clear();
+}
+
+Entity* World::createEntity(const EntityState& state)
+{
+	switch (state.kind)
+	{
+		case EntityState::AircraftEntity:
+		{
+			std::unique_ptr<Aircraft> aircraft;
+			if (state.identifier != 0)
+				aircraft.reset(new Aircraft(static_cast<Aircraft::Type>(state.type), mTextures, mFonts, mTimers, mBehaviors, mParticleSystems));
+			else
+				aircraft = mEnemyPool.acquire(static_cast<Aircraft::Type>(state.type));
+
+			Aircraft* result = aircraft.get();
+			if (state.identifier != 0)
+				mPlayerAircrafts.push_back(result);
+
+			mSceneLayers[UpperAir]->attachChild(std::move(aircraft));
+			return result;
+		}
+
+		case EntityState::ProjectileEntity:
+		{
+			std::unique_ptr<Projectile> projectile(new Projectile(static_cast<Projectile::Type>(state.type), mTextures, mParticleSystems));
+			Projectile* result = projectile.get();
+
+			mSceneLayers[LowerAir]->attachChild(std::move(projectile));
+			return result;
+		}
+
+		default:
+		{
+			std::unique_ptr<Pickup> pickup(new Pickup(static_cast<Pickup::Type>(state.type), mTextures));
+			Pickup* result = pickup.get();
+
+			mSceneLayers[LowerAir]->attachChild(std::move(pickup));
+			return result;
+		}
+	}
+}
+
 void World::buildScene()
 {
 	// Initialize the different layers
@@ -241,565 +838,219 @@ void World::buildScene()
 	sf::IntRect textureRect(mWorldBounds);
 	textureRect.height += static_cast<int>(viewHeight);
 
-	// Add enemy aircrafts
-	addEnemies();
-
 	// Prepare the tiled background	
 	sf::Texture& chosenTexture = mTextures.get(mLevel == 1 ? Textures::Jungle : (mLevel == 2 ? Textures::Space1 : (mLevel == 3 ? Textures::Space2 : Textures::Space3)));
 	chosenTexture.setRepeated(true);
-	++mLevel;
 
+	if (mMode == Endless)
+	{
+		// Generate the first chunk of enemies a little ahead of the player, like the levels do
+		mChunkOrigin = mSpawnPosition - sf::Vector2f(0.f, viewHeight);
+		startChunk(0);
 
+		// The background only covers the view plus one texture tile, scrollBackground() keeps it under the view
+		mBackgroundTileHeight = static_cast<float>(chosenTexture.getSize().y);
+		textureRect.height = static_cast<int>(viewHeight + mBackgroundTileHeight);
+	}
+	else
+	{
+		// Map the enemies of the level, they are spawned straight from the file
+		mLevelData.loadFromFile("Media/Levels/Level" + toString(mLevel) + ".lvl");
+	}
+
+	++mLevel;
 
 	// Add the background sprite to the scene
 	std::unique_ptr<SpriteNode> chosenSprite(new SpriteNode(chosenTexture, textureRect));
-	chosenSprite->setPosition(mWorldBounds.left, mWorldBounds.top - viewHeight);
+	if (mMode == Endless)
+		chosenSprite->setPosition(mWorldBounds.left, mSpawnPosition.y - viewHeight / 2.f);
+	else
+		chosenSprite->setPosition(mWorldBounds.left, mWorldBounds.top - viewHeight);
+	mBackground = chosenSprite.get();
 	mSceneLayers[Background]->attachChild(std::move(chosenSprite));
 
 	// Add the finish line to the scene
-	sf::Texture& finishTexture = mTextures.get(Textures::FinishLine);
-	std::unique_ptr<SpriteNode> finishSprite(new SpriteNode(finishTexture));
-	finishSprite->setPosition(0.f, -76.f);
-	mSceneLayers[Background]->attachChild(std::move(finishSprite));
+	if (mMode == Campaign)
+	{
+		sf::Texture& finishTexture = mTextures.get(Textures::FinishLine);
+		std::unique_ptr<SpriteNode> finishSprite(new SpriteNode(finishTexture));
+		finishSprite->setPosition(0.f, -76.f);
+		mSceneLayers[Background]->attachChild(std::move(finishSprite));
+	}
 
-	// Add particle node to the scene
-	std::unique_ptr<ParticleNode> smokeNode(new ParticleNode(Particle::Smoke, mTextures));
+	// Add particle node to the scene, emitters find it through the registry
+	std::unique_ptr<ParticleNode> smokeNode(new ParticleNode(Particle::Smoke, mTextures, mShaders, mWorkers, mParticleBudget));
+	mParticleSystems.add(*smokeNode);
 	mSceneLayers[LowerAir]->attachChild(std::move(smokeNode));
 
-	// Add propellant particle node to the scene
-	std::unique_ptr<ParticleNode> propellantNode(new ParticleNode(Particle::Propellant, mTextures));
-	mSceneLayers[LowerAir]->attachChild(std::move(propellantNode));
+	// Add the explosions of destroyed aircraft
+	std::unique_ptr<ExplosionNode> explosionNode(new ExplosionNode(mAnimations));
+	mExplosions = explosionNode.get();
+	mSceneLayers[Explosions]->attachChild(std::move(explosionNode));
+
+	// Add the missile trails, missiles find them through the registry
+	std::unique_ptr<TrailNode> trailNode(new TrailNode());
+	mParticleSystems.setTrails(*trailNode);
+	mSceneLayers[LowerAir]->attachChild(std::move(trailNode));
+
+	// Add the store for all unguided bullets
+	std::unique_ptr<BulletNode> bulletNode(new BulletNode(mTextures, mPlayerAircrafts));
+	mBullets = bulletNode.get();
+	mSceneLayers[LowerAir]->attachChild(std::move(bulletNode));
 
 	// Add sound effect node
 	std::unique_ptr<SoundNode> soundNode(new SoundNode(mSounds));
 	mSceneGraph.attachChild(std::move(soundNode));
 
 	// Add player's aircraft
-	std::unique_ptr<Aircraft> player(new Aircraft(Aircraft::Eagle, mTextures, mFonts));
-	mPlayerAircraft = player.get();
-	mPlayerAircraft->setPosition(mSpawnPosition);
-	mSceneLayers[UpperAir]->attachChild(std::move(player));
+	addAircraft(1);
 
 }
 
-void World::addEnemies()
-{
-	// Add enemies to the spawn point container
-
-	// * * *   LEVEL 1   * * * 
-	if (mLevel == 1) {
-		addEnemy(Aircraft::Raptor, 0.f, 1350.f);
-		addEnemy(Aircraft::Raptor, +100.f, 1350.f);
-		addEnemy(Aircraft::Raptor, -100.f, 1350.f);
-
-		addEnemy(Aircraft::Avenger, 100.f, 1500.f);
-		addEnemy(Aircraft::Avenger, -100.f, 1500.f);
-		addEnemy(Aircraft::Avenger, -240.f, 1500.f);
-		addEnemy(Aircraft::Avenger, 240.f, 1500.f);
-		addEnemy(Aircraft::Raptor, 150.f, 1700.f);
-		addEnemy(Aircraft::Raptor, -150.f, 1700.f);
-		addEnemy(Aircraft::Avenger, 300.f, 1850.f);
-		addEnemy(Aircraft::Avenger, -300.f, 1850.f);
-		addEnemy(Aircraft::Avenger, 420.f, 2000.f);
-		addEnemy(Aircraft::Avenger, -420.f, 2000.f);
-
-		addEnemy(Aircraft::Raptor, 50.f, 2150.f);
-		addEnemy(Aircraft::Raptor, -50.f, 2150.f);
-		addEnemy(Aircraft::Raptor, 300.f, 2200.f);
-		addEnemy(Aircraft::Raptor, -300.f, 2200.f);
-		addEnemy(Aircraft::Raptor, 125.f, 2350.f);
-		addEnemy(Aircraft::Raptor, -125.f, 2350.f);
-		addEnemy(Aircraft::Avenger, 200.f, 2700.f);
-		addEnemy(Aircraft::Avenger, -200.f, 2700.f);
-		addEnemy(Aircraft::Avenger, 420.f, 2700.f);
-		addEnemy(Aircraft::Avenger, -420.f, 2700.f);
-
-		addEnemy(Aircraft::Raptor, 0.f, 3450.f);
-		addEnemy(Aircraft::Raptor, 100.f, 3450.f);
-		addEnemy(Aircraft::Raptor, -100.f, 3450.f);
-		addEnemy(Aircraft::Raptor, 250.f, 3450.f);
-		addEnemy(Aircraft::Raptor, -250.f, 3450.f);
-		addEnemy(Aircraft::Avenger, 0.f, 3650.f);
-		addEnemy(Aircraft::Avenger, 75.f, 3650.f);
-		addEnemy(Aircraft::Avenger, -75.f, 3650.f);
-		addEnemy(Aircraft::Avenger, 420.f, 3650.f);
-		addEnemy(Aircraft::Avenger, -420.f, 3650.f);
-
-		addEnemy(Aircraft::Avenger, 0.f, 4000.f);
-		addEnemy(Aircraft::Avenger, 300.f, 4000.f);
-		addEnemy(Aircraft::Avenger, -300.f, 4000.f);
-		addEnemy(Aircraft::Raptor, 200.f, 4250.f);
-		addEnemy(Aircraft::Raptor, -200.f, 4250.f);
-		addEnemy(Aircraft::Avenger, 0.f, 4800.f);
-		addEnemy(Aircraft::Avenger, 150.f, 4800.f);
-		addEnemy(Aircraft::Avenger, -150.f, 4800.f);
-		addEnemy(Aircraft::Avenger, 420.f, 4500.f);
-		addEnemy(Aircraft::Avenger, -420.f, 4500.f);
-
-
-		addEnemy(Aircraft::Avenger, 0.f, 5000.f);
-		addEnemy(Aircraft::Avenger, 250.f, 5250.f);
-		addEnemy(Aircraft::Avenger, -250.f, 5250.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5350.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5450.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5550.f);
-		addEnemy(Aircraft::Avenger, -200.f, 5600.f);
-		addEnemy(Aircraft::Avenger, 200.f, 5600.f);
-		addEnemy(Aircraft::Avenger, 420.f, 5600.f);
-		addEnemy(Aircraft::Avenger, -420.f, 5600.f);
-
-
-		addEnemy(Aircraft::Avenger, 0.f, 6000.f);
-		addEnemy(Aircraft::Raptor, 150.f, 6000.f);
-		addEnemy(Aircraft::Raptor, -150.f, 6000.f);
-		addEnemy(Aircraft::Avenger, 300.f, 6000.f);
-		addEnemy(Aircraft::Avenger, -300.f, 6000.f);
-		addEnemy(Aircraft::Avenger, 100.f, 6200.f);
-		addEnemy(Aircraft::Avenger, -100.f, 6200.f);
-		addEnemy(Aircraft::Avenger, 0.f, 6200.f);
-		addEnemy(Aircraft::Avenger, 420.f, 6200.f);
-		addEnemy(Aircraft::Avenger, -420.f, 6200.f);
-
-		addEnemy(Aircraft::Raptor, -75.f, 6450.f);
-		addEnemy(Aircraft::Raptor, 75.f, 6450.f);
-		addEnemy(Aircraft::Raptor, 300.f, 6450.f);
-		addEnemy(Aircraft::Raptor, -300.f, 6450.f);
-
-		addEnemy(Aircraft::Avenger, -200.f, 6650.f);
-		addEnemy(Aircraft::Avenger, 200.f, 6650.f);
-		addEnemy(Aircraft::Avenger, 0.f, 6700.f);
-		addEnemy(Aircraft::Avenger, 100.f, 6750.f);
-		addEnemy(Aircraft::Avenger, -100.f, 6750.f);
-
-		addEnemy(Aircraft::Avenger, 420.f, 7000.f);
-		addEnemy(Aircraft::Avenger, -420.f, 7000.f);
-		addEnemy(Aircraft::Raptor, 0.f, 7050.f);
-		addEnemy(Aircraft::Raptor, +100.f, 7350.f);
-		addEnemy(Aircraft::Raptor, -100.f, 7350.f);
-		addEnemy(Aircraft::Avenger, 100.f, 7500.f);
-		addEnemy(Aircraft::Avenger, -100.f, 7500.f);
-		addEnemy(Aircraft::Avenger, -240.f, 7500.f);
-		addEnemy(Aircraft::Avenger, 240.f, 7500.f);
-		addEnemy(Aircraft::Raptor, 150.f, 7700.f);
-		addEnemy(Aircraft::Raptor, -150.f, 7700.f);
-		addEnemy(Aircraft::Avenger, 300.f, 7850.f);
-		addEnemy(Aircraft::Avenger, -300.f, 7850.f);
-
-
-		addEnemy(Aircraft::Raptor, 125.f, 8150.f);
-		addEnemy(Aircraft::Raptor, 230.f, 8150.f);
-		addEnemy(Aircraft::Raptor, -125.f, 8150.f);
-		addEnemy(Aircraft::Raptor, -230.f, 8150.f);
-		addEnemy(Aircraft::Raptor, 0.f, 8500.f);
-
-		addEnemy(Aircraft::Raptor, 125.f, 9150.f);
-		addEnemy(Aircraft::Raptor, 170.f, 9150.f);
-		addEnemy(Aircraft::Raptor, -125.f, 9150.f);
-		addEnemy(Aircraft::Raptor, -170.f, 9150.f);
-		addEnemy(Aircraft::Raptor, 50.f, 9300.f);
-		addEnemy(Aircraft::Raptor, -50.f, 9300.f);
-		addEnemy(Aircraft::Raptor, 350.f, 9600.f);
-		addEnemy(Aircraft::Raptor, -350.f, 9600.f);
-
-	}
-	else if (mLevel == 2)
-	{
-
-		addEnemy(Aircraft::Raptor, 0.f, 9750.f);
-		addEnemy(Aircraft::Raptor, +100.f, 9750.f);
-		addEnemy(Aircraft::Raptor, -100.f, 9750.f);
-		addEnemy(Aircraft::Avenger, 100.f, 9500.f);
-		addEnemy(Aircraft::Avenger, -100.f, 9500.f);
-		addEnemy(Aircraft::Avenger, -240.f, 9500.f);
-		addEnemy(Aircraft::Avenger, 240.f, 9500.f);
-		addEnemy(Aircraft::Raptor, 150.f, 9300.f);
-		addEnemy(Aircraft::Raptor, -150.f, 9300.f);
-		addEnemy(Aircraft::Avenger, 300.f, 9250.f);
-		addEnemy(Aircraft::Avenger, -300.f, 9250.f);
-		addEnemy(Aircraft::Avenger, 420.f, 9250.f);
-		addEnemy(Aircraft::Avenger, -420.f, 9250.f);
-
-		addEnemy(Aircraft::Raptor, 50.f, 8950.f);
-		addEnemy(Aircraft::Raptor, -50.f, 8950.f);
-		addEnemy(Aircraft::Raptor, 300.f, 8800.f);
-		addEnemy(Aircraft::Raptor, -300.f, 8800.f);
-		addEnemy(Aircraft::Raptor, 125.f, 8750.f);
-		addEnemy(Aircraft::Raptor, -125.f, 8450.f);
-		addEnemy(Aircraft::Avenger, 200.f, 8300.f);
-		addEnemy(Aircraft::Avenger, -200.f, 8300.f);
-		addEnemy(Aircraft::Avenger, 420.f, 8400.f);
-		addEnemy(Aircraft::Avenger, -420.f, 8400.f);
-
-		addEnemy(Aircraft::Raptor, 0.f, 7950.f);
-		addEnemy(Aircraft::Raptor, 100.f, 7650.f);
-		addEnemy(Aircraft::Raptor, -100.f, 7650.f);
-		addEnemy(Aircraft::Raptor, 250.f, 7450.f);
-		addEnemy(Aircraft::Raptor, -250.f, 7450.f);
-		addEnemy(Aircraft::Avenger, 0.f, 7350.f);
-		addEnemy(Aircraft::Avenger, 75.f, 7050.f);
-		addEnemy(Aircraft::Avenger, -75.f, 7050.f);
-		addEnemy(Aircraft::Avenger, 420.f, 7300.f);
-		addEnemy(Aircraft::Avenger, -420.f, 7300.f);
-
-		addEnemy(Aircraft::Avenger, 0.f, 6800.f);
-		addEnemy(Aircraft::Avenger, 300.f, 6800.f);
-		addEnemy(Aircraft::Avenger, -300.f, 6800.f);
-		addEnemy(Aircraft::Raptor, 200.f, 6550.f);
-		addEnemy(Aircraft::Raptor, -200.f, 6550.f);
-		addEnemy(Aircraft::Avenger, 0.f, 6300.f);
-		addEnemy(Aircraft::Avenger, 150.f, 6100.f);
-		addEnemy(Aircraft::Avenger, -150.f, 6100.f);
-		addEnemy(Aircraft::Raptor, 350.f, 6000.f);
-		addEnemy(Aircraft::Raptor, -350.f, 6000.f);
-		addEnemy(Aircraft::Avenger, 420.f, 6200.f);
-		addEnemy(Aircraft::Avenger, -420.f, 6200.f);
-
-
-		addEnemy(Aircraft::Avenger, 0.f, 5000.f);
-		addEnemy(Aircraft::Avenger, 250.f, 5250.f);
-		addEnemy(Aircraft::Avenger, -250.f, 5250.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5350.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5450.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5550.f);
-		addEnemy(Aircraft::Avenger, -200.f, 5600.f);
-		addEnemy(Aircraft::Avenger, 200.f, 5600.f);
-		addEnemy(Aircraft::Avenger, 420.f, 5300.f);
-		addEnemy(Aircraft::Avenger, -420.f, 5300.f);
-
-
-		addEnemy(Aircraft::Avenger, 0.f, 4000.f);
-		addEnemy(Aircraft::Raptor, 150.f, 4000.f);
-		addEnemy(Aircraft::Raptor, -150.f, 4000.f);
-		addEnemy(Aircraft::Avenger, 300.f, 4000.f);
-		addEnemy(Aircraft::Avenger, -300.f, 4000.f);
-		addEnemy(Aircraft::Avenger, 420.f, 4000.f);
-		addEnemy(Aircraft::Avenger, -420.f, 4000.f);
-		addEnemy(Aircraft::Avenger, 100.f, 3800.f);
-		addEnemy(Aircraft::Avenger, -100.f, 3800.f);
-		addEnemy(Aircraft::Avenger, 0.f, 3800.f);
-
-		addEnemy(Aircraft::Avenger, 420.f, 3000.f);
-		addEnemy(Aircraft::Avenger, -420.f, 3000.f);
-		addEnemy(Aircraft::Raptor, -75.f, 3350.f);
-		addEnemy(Aircraft::Raptor, 75.f, 3350.f);
-		addEnemy(Aircraft::Raptor, 300.f, 3350.f);
-		addEnemy(Aircraft::Raptor, -300.f, 3350.f);
-
-		addEnemy(Aircraft::Avenger, -200.f, 2550.f);
-		addEnemy(Aircraft::Avenger, 200.f, 2550.f);
-		addEnemy(Aircraft::Avenger, 0.f, 2400.f);
-		addEnemy(Aircraft::Avenger, 100.f, 2350.f);
-		addEnemy(Aircraft::Avenger, -100.f, 2350.f);
-
-		addEnemy(Aircraft::Raptor, 0.f, 2100.f);
-		addEnemy(Aircraft::Raptor, +100.f, 2050.f);
-		addEnemy(Aircraft::Raptor, -100.f, 2050.f);
-		addEnemy(Aircraft::Avenger, 420.f, 2000.f);
-		addEnemy(Aircraft::Avenger, -420.f, 2000.f);
-		addEnemy(Aircraft::Avenger, 100.f, 1900.f);
-		addEnemy(Aircraft::Avenger, -100.f, 1900.f);
-		addEnemy(Aircraft::Avenger, -240.f, 1700.f);
-		addEnemy(Aircraft::Avenger, 240.f, 1700.f);
-		addEnemy(Aircraft::Raptor, 150.f, 1600.f);
-		addEnemy(Aircraft::Raptor, -150.f, 1600.f);
-		addEnemy(Aircraft::Avenger, 300.f, 1550.f);
-		addEnemy(Aircraft::Avenger, -300.f, 1550.f);
-
-
-		addEnemy(Aircraft::Raptor, 125.f, 1350.f);
-		addEnemy(Aircraft::Raptor, 230.f, 1350.f);
-		addEnemy(Aircraft::Raptor, -125.f, 1350.f);
-		addEnemy(Aircraft::Raptor, -230.f, 1350.f);
-		addEnemy(Aircraft::Raptor, 0.f, 1350.f);
-
-	}
-
-	else if (mLevel == 3)
-	{
-		addEnemy(Aircraft::Raptor, 0.f, 850.f);
-		addEnemy(Aircraft::Raptor, +200.f, 1350.f);
-		addEnemy(Aircraft::Raptor, -200.f, 1350.f);
-		addEnemy(Aircraft::Avenger, 100.f, 1500.f);
-		addEnemy(Aircraft::Avenger, -100.f, 1500.f);
-		addEnemy(Aircraft::Avenger, -200.f, 1600.f);
-		addEnemy(Aircraft::Avenger, 200.f, 1600.f);
-		addEnemy(Aircraft::Raptor, 150.f, 1700.f);
-		addEnemy(Aircraft::Avenger, 420.f, 1700.f);
-		addEnemy(Aircraft::Avenger, -420.f, 1700.f);
-		addEnemy(Aircraft::Raptor, -150.f, 1700.f);
-		addEnemy(Aircraft::Avenger, 300.f, 1850.f);
-		addEnemy(Aircraft::Avenger, -300.f, 1850.f);
-
-		addEnemy(Aircraft::Raptor, 50.f, 2150.f);
-		addEnemy(Aircraft::Raptor, -50.f, 2150.f);
-		addEnemy(Aircraft::Raptor, 300.f, 2200.f);
-		addEnemy(Aircraft::Raptor, -300.f, 2200.f);
-		addEnemy(Aircraft::Raptor, 125.f, 2350.f);
-		addEnemy(Aircraft::Raptor, -125.f, 2350.f);
-		addEnemy(Aircraft::Avenger, 420.f, 2300.f);
-		addEnemy(Aircraft::Avenger, -420.f, 2300.f);
-		addEnemy(Aircraft::Avenger, 200.f, 2700.f);
-		addEnemy(Aircraft::Avenger, -200.f, 2700.f);
-
-		addEnemy(Aircraft::Raptor, 0.f, 3450.f);
-		addEnemy(Aircraft::Raptor, 100.f, 3450.f);
-		addEnemy(Aircraft::Raptor, -100.f, 3450.f);
-		addEnemy(Aircraft::Raptor, 250.f, 3450.f);
-		addEnemy(Aircraft::Raptor, -250.f, 3450.f);
-		addEnemy(Aircraft::Avenger, 420.f, 3450.f);
-		addEnemy(Aircraft::Avenger, -420.f, 3450.f);
-		addEnemy(Aircraft::Avenger, 0.f, 3650.f);
-		addEnemy(Aircraft::Avenger, 75.f, 3650.f);
-		addEnemy(Aircraft::Avenger, -75.f, 3650.f);
-
-		addEnemy(Aircraft::Avenger, 0.f, 4000.f);
-		addEnemy(Aircraft::Avenger, 300.f, 4000.f);
-		addEnemy(Aircraft::Avenger, -300.f, 4000.f);
-		addEnemy(Aircraft::Raptor, 200.f, 4250.f);
-		addEnemy(Aircraft::Raptor, -200.f, 4250.f);
-		addEnemy(Aircraft::Avenger, 420.f, 4600.f);
-		addEnemy(Aircraft::Avenger, -420.f, 4600.f);
-		addEnemy(Aircraft::Avenger, 0.f, 4800.f);
-		addEnemy(Aircraft::Avenger, 150.f, 4800.f);
-		addEnemy(Aircraft::Avenger, -150.f, 4800.f);
-		addEnemy(Aircraft::Raptor, 350.f, 4800.f);
-		addEnemy(Aircraft::Raptor, -350.f, 4800.f);
-
-
-		addEnemy(Aircraft::Raptor, 0.f, 9750.f);
-		addEnemy(Aircraft::Raptor, +100.f, 9750.f);
-		addEnemy(Aircraft::Raptor, -100.f, 9750.f);
-		addEnemy(Aircraft::Avenger, 100.f, 9500.f);
-		addEnemy(Aircraft::Avenger, -100.f, 9500.f);
-		addEnemy(Aircraft::Avenger, -240.f, 9500.f);
-		addEnemy(Aircraft::Avenger, 240.f, 9500.f);
-		addEnemy(Aircraft::Avenger, 420.f, 9500.f);
-		addEnemy(Aircraft::Avenger, -420.f, 9500.f);
-		addEnemy(Aircraft::Raptor, 150.f, 9300.f);
-		addEnemy(Aircraft::Raptor, -150.f, 9300.f);
-		addEnemy(Aircraft::Avenger, 300.f, 9250.f);
-		addEnemy(Aircraft::Avenger, -300.f, 9250.f);
-
-		addEnemy(Aircraft::Raptor, 50.f, 8950.f);
-		addEnemy(Aircraft::Raptor, -50.f, 8950.f);
-		addEnemy(Aircraft::Raptor, 300.f, 8800.f);
-		addEnemy(Aircraft::Raptor, -300.f, 8800.f);
-		addEnemy(Aircraft::Raptor, 125.f, 8750.f);
-		addEnemy(Aircraft::Raptor, -125.f, 8450.f);
-		addEnemy(Aircraft::Avenger, 200.f, 8300.f);
-		addEnemy(Aircraft::Avenger, -200.f, 8300.f);
-		addEnemy(Aircraft::Avenger, 420.f, 8400.f);
-		addEnemy(Aircraft::Avenger, -420.f, 8400.f);
-
-		addEnemy(Aircraft::Raptor, 0.f, 7950.f);
-		addEnemy(Aircraft::Raptor, 100.f, 7650.f);
-		addEnemy(Aircraft::Raptor, -100.f, 7650.f);
-		addEnemy(Aircraft::Raptor, 250.f, 7450.f);
-		addEnemy(Aircraft::Raptor, -250.f, 7450.f);
-		addEnemy(Aircraft::Avenger, 0.f, 7350.f);
-		addEnemy(Aircraft::Avenger, 75.f, 7050.f);
-		addEnemy(Aircraft::Avenger, -75.f, 7050.f);
-		addEnemy(Aircraft::Avenger, 420.f, 7200.f);
-		addEnemy(Aircraft::Avenger, -420.f, 7200.f);
-
-		addEnemy(Aircraft::Avenger, 0.f, 6800.f);
-		addEnemy(Aircraft::Avenger, 300.f, 6800.f);
-		addEnemy(Aircraft::Avenger, -300.f, 6800.f);
-		addEnemy(Aircraft::Raptor, 200.f, 6550.f);
-		addEnemy(Aircraft::Raptor, -200.f, 6550.f);
-		addEnemy(Aircraft::Avenger, 0.f, 6300.f);
-		addEnemy(Aircraft::Avenger, 150.f, 6100.f);
-		addEnemy(Aircraft::Avenger, 420.f, 6100.f);
-		addEnemy(Aircraft::Avenger, -420.f, 6100.f);
-		addEnemy(Aircraft::Avenger, -150.f, 6100.f);
-		addEnemy(Aircraft::Raptor, 350.f, 6000.f);
-		addEnemy(Aircraft::Raptor, -350.f, 6000.f);
-
-
-		addEnemy(Aircraft::Avenger, 0.f, 5000.f);
-		addEnemy(Aircraft::Avenger, 250.f, 5250.f);
-		addEnemy(Aircraft::Avenger, -250.f, 5250.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5350.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5450.f);
-		addEnemy(Aircraft::Avenger, 420.f, 5200.f);
-		addEnemy(Aircraft::Avenger, -420.f, 5200.f);
-		addEnemy(Aircraft::Raptor, 0.f, 5550.f);
-		addEnemy(Aircraft::Avenger, -200.f, 5600.f);
-		addEnemy(Aircraft::Avenger, 200.f, 5600.f);
-
-	}
-
-	else if (mLevel == 4)
-	{
-		//BOSS TIME
-
-		addEnemy(Aircraft::C83, 0.f, 9750.f);
-		addEnemy(Aircraft::C83, +100.f, 9750.f);
-		addEnemy(Aircraft::C83, -100.f, 9750.f);
-		addEnemy(Aircraft::C83, 100.f, 9500.f);
-		addEnemy(Aircraft::C83, -100.f, 9500.f);
-		addEnemy(Aircraft::C83, -240.f, 9500.f);
-		addEnemy(Aircraft::C83, 240.f, 9500.f);
-		addEnemy(Aircraft::C83, 150.f, 9300.f);
-		addEnemy(Aircraft::C83, -150.f, 9300.f);
-		addEnemy(Aircraft::C83, 420.f, 9150.f);
-		addEnemy(Aircraft::C83, -420.f, 9150.f);
-		addEnemy(Aircraft::C83, 300.f, 9250.f);
-		addEnemy(Aircraft::C83, -300.f, 9250.f);
-		addEnemy(Aircraft::C83, 375.f, 9250.f);
-		addEnemy(Aircraft::C83, -375.f, 9250.f);
-
-		addEnemy(Aircraft::C83, 50.f, 8950.f);
-		addEnemy(Aircraft::C83, -50.f, 8950.f);
-		addEnemy(Aircraft::C83, 300.f, 8800.f);
-		addEnemy(Aircraft::C83, -300.f, 8800.f);
-		addEnemy(Aircraft::C83, 125.f, 8750.f);
-		addEnemy(Aircraft::C83, -125.f, 8450.f);
-		addEnemy(Aircraft::C83, 200.f, 8300.f);
-		addEnemy(Aircraft::C83, -200.f, 8300.f);
-		addEnemy(Aircraft::C83, 375.f, 8300.f);
-		addEnemy(Aircraft::C83, -375.f, 8300.f);
-		addEnemy(Aircraft::C83, 420.f, 8550.f);
-		addEnemy(Aircraft::C83, -420.f, 8550.f);
-
-
-		addEnemy(Aircraft::C83, 0.f, 7950.f);
-		addEnemy(Aircraft::C83, 100.f, 7650.f);
-		addEnemy(Aircraft::C83, -100.f, 7650.f);
-		addEnemy(Aircraft::C83, -175.f, 7450.f);
-		addEnemy(Aircraft::C83, 205.f, 7650.f);
-		addEnemy(Aircraft::C83, -175.f, 7450.f);
-		addEnemy(Aircraft::C83, 0.f, 7375.f);
-		addEnemy(Aircraft::C83, 75.f, 7050.f);
-		addEnemy(Aircraft::C83, -75.f, 7050.f);
-		addEnemy(Aircraft::C83, 100.f, 7300.f);
-		addEnemy(Aircraft::C83, 420.f, 7250.f);
-		addEnemy(Aircraft::C83, -420.f, 7250.f);
-		addEnemy(Aircraft::C83, 355.f, 7050.f);
-		addEnemy(Aircraft::C83, -375.f, 7050.f);
-
-		addEnemy(Aircraft::C83, 0.f, 6800.f);
-		addEnemy(Aircraft::C83, 300.f, 6800.f);
-		addEnemy(Aircraft::C83, -300.f, 6800.f);
-		addEnemy(Aircraft::C83, 200.f, 6550.f);
-		addEnemy(Aircraft::C83, 420.f, 6550.f);
-		addEnemy(Aircraft::C83, -420.f, 6550.f);
-		addEnemy(Aircraft::C83, -200.f, 6550.f);
-		addEnemy(Aircraft::C83, 0.f, 6300.f);
-		addEnemy(Aircraft::C83, 150.f, 6100.f);
-		addEnemy(Aircraft::C83, -150.f, 6100.f);
-		addEnemy(Aircraft::C83, 375.f, 6000.f);
-		addEnemy(Aircraft::C83, -375.f, 6000.f);
-
-
-		addEnemy(Aircraft::C83, 0.f, 5000.f);
-		addEnemy(Aircraft::C83, 250.f, 5250.f);
-		addEnemy(Aircraft::C83, -250.f, 5250.f);
-		addEnemy(Aircraft::C83, -50.f, 5300.f);
-		addEnemy(Aircraft::C83, 50.f, 5300.f);
-		addEnemy(Aircraft::C83, 0.f, 5375.f);
-		addEnemy(Aircraft::C83, 420.f, 5550.f);
-		addEnemy(Aircraft::C83, -420.f, 5550.f);
-		addEnemy(Aircraft::C83, 180.f, 5550.f);
-		addEnemy(Aircraft::C83, -180.f, 5550.f);
-		addEnemy(Aircraft::C83, -200.f, 5700.f);
-		addEnemy(Aircraft::C83, 200.f, 5700.f);
-		addEnemy(Aircraft::C83, -375.f, 5700.f);
-		addEnemy(Aircraft::C83, 375.f, 5700.f);
-
-
-
-
-		addEnemy(Aircraft::C83, 0.f, 4000.f);
-		addEnemy(Aircraft::C83, 150.f, 4000.f);
-		addEnemy(Aircraft::C83, -150.f, 4000.f);
-		addEnemy(Aircraft::C83, 300.f, 4000.f);
-		addEnemy(Aircraft::C83, -300.f, 4000.f);
-		addEnemy(Aircraft::C83, 375.f, 4600.f);
-		addEnemy(Aircraft::C83, -375.f, 4600.f);
-		addEnemy(Aircraft::C83, 420.f, 4350.f);
-		addEnemy(Aircraft::C83, -420.f, 4350.f);
-
-
-
-		addEnemy(Aircraft::C83, 100.f, 3800.f);
-		addEnemy(Aircraft::C83, -100.f, 3800.f);
-		addEnemy(Aircraft::C83, 0.f, 3800.f);
-		addEnemy(Aircraft::C83, -75.f, 3350.f);
-		addEnemy(Aircraft::C83, 75.f, 3350.f);
-		addEnemy(Aircraft::C83, 150.f, 3350.f);
-		addEnemy(Aircraft::C83, -150.f, 3350.f);
-		addEnemy(Aircraft::C83, 300.f, 3350.f);
-		addEnemy(Aircraft::C83, -300.f, 3350.f);
-		addEnemy(Aircraft::C83, 375.f, 3350.f);
-		addEnemy(Aircraft::C83, -375.f, 3350.f);
-		addEnemy(Aircraft::C83, 420.f, 3550.f);
-		addEnemy(Aircraft::C83, -420.f, 3550.f);
-
-		addEnemy(Aircraft::C83, -200.f, 2550.f);
-		addEnemy(Aircraft::C83, 200.f, 2550.f);
-		addEnemy(Aircraft::C83, 0.f, 2400.f);
-		addEnemy(Aircraft::C83, 100.f, 2350.f);
-		addEnemy(Aircraft::C83, -100.f, 2350.f);
-		addEnemy(Aircraft::C83, -375.f, 2350.f);
-		addEnemy(Aircraft::C83, 375.f, 2350.f);
-
-		addEnemy(Aircraft::C83, 0.f, 2100.f);
-		addEnemy(Aircraft::C83, +100.f, 2050.f);
-		addEnemy(Aircraft::C83, -100.f, 2050.f);
-		addEnemy(Aircraft::C83, 100.f, 1900.f);
-		addEnemy(Aircraft::C83, -100.f, 1900.f);
-		addEnemy(Aircraft::C83, -240.f, 1700.f);
-		addEnemy(Aircraft::C83, 240.f, 1700.f);
-		addEnemy(Aircraft::C83, 150.f, 1600.f);
-		addEnemy(Aircraft::C83, -150.f, 1600.f);
-		addEnemy(Aircraft::C83, 300.f, 1550.f);
-		addEnemy(Aircraft::C83, -300.f, 1550.f);
-		addEnemy(Aircraft::C83, 375.f, 1550.f);
-		addEnemy(Aircraft::C83, -375.f, 1550.f);
-
-
-		addEnemy(Aircraft::C83, -320.f, 1250.f);
-		addEnemy(Aircraft::C83, 320.f, 1250.f);
-		addEnemy(Aircraft::C83, 125.f, 1350.f);
-		addEnemy(Aircraft::C83, 230.f, 1350.f);
-		addEnemy(Aircraft::C83, -125.f, 1350.f);
-		addEnemy(Aircraft::C83, -230.f, 1350.f);
-		addEnemy(Aircraft::C83, 0.f, 1350.f);
-		addEnemy(Aircraft::C83, -425.f, 1350.f);
-		addEnemy(Aircraft::C83, 425.f, 1350.f);
-	}
-
-	// Sort all enemies according to their y value, such that lower enemies are checked first for spawning
-	std::sort(mEnemySpawnPoints.begin(), mEnemySpawnPoints.end(), [](SpawnPoint lhs, SpawnPoint rhs)
-	{
-		return lhs.y < rhs.y;
-	});
+void World::prefetchEnemies()
+{
+	// Reserve the enemies of the spawns a few screens ahead, the pool builds the missing ones on its worker thread
+	const LevelFormat::Spawn* spawns = (mMode == Endless) ? mChunkSpawns.data() : mLevelData.getSpawns();
+	std::size_t count = (mMode == Endless) ? mChunkSpawns.size() : mLevelData.getSpawnCount();
+	sf::Vector2f origin = (mMode == Endless) ? mChunkOrigin : mSpawnPosition;
+	float horizon = getViewBounds().top - PrefetchScreens * mWorldView.getSize().y;
+
+	mPrefetchPoint = std::max(mPrefetchPoint, mNextSpawnPoint);
+	while (mPrefetchPoint < count && origin.y - spawns[mPrefetchPoint].distance > horizon)
+	{
+		if (spawns[mPrefetchPoint].type != LevelFormat::SwarmType)
+			mEnemyPool.reserve(static_cast<Aircraft::Type>(spawns[mPrefetchPoint].type));
+
+		++mPrefetchPoint;
+	}
 }
 
-void World::addEnemy(Aircraft::Type type, float relX, float relY)
+void World::spawnEnemies()
 {
-	SpawnPoint spawn(type, mSpawnPosition.x + relX, mSpawnPosition.y - relY);
-	mEnemySpawnPoints.push_back(spawn);
+	// Spawn all enemies entering the view area (including distance) this frame.
+	// Spawns are sorted by distance, so the cursor only ever looks at the next one
+	float battlefieldTop = getBattlefieldBounds().top;
+
+	if (mMode == Endless)
+	{
+		// A chunk is retired as soon as its last enemy is out, and the next one takes its buffer
+		if (mNextSpawnPoint == mChunkSpawns.size())
+		{
+			mChunkOrigin.y -= EndlessGenerator::ChunkHeight;
+			startChunk(mChunkIndex + 1);
+		}
+
+		while (mNextSpawnPoint < mChunkSpawns.size())
+		{
+			const LevelFormat::Spawn& spawn = mChunkSpawns[mNextSpawnPoint];
+			sf::Vector2f position(mChunkOrigin.x + spawn.x, mChunkOrigin.y - spawn.distance);
+			if (position.y <= battlefieldTop)
+				break;
+
+			mNextSpawnPoint = spawnGroup(mChunkSpawns.data(), mChunkSpawns.size(), mNextSpawnPoint, mChunkOrigin);
+		}
+	}
+	else
+	{
+		while (mNextSpawnPoint < mLevelData.getSpawnCount())
+		{
+			const LevelFormat::Spawn& spawn = mLevelData.getSpawn(mNextSpawnPoint);
+			sf::Vector2f position(mSpawnPosition.x + spawn.x, mSpawnPosition.y - spawn.distance);
+			if (position.y <= battlefieldTop)
+				break;
+
+			// Enemies are spawned, advance to the next ones (the file is kept for rewinding)
+			mNextSpawnPoint = spawnGroup(mLevelData.getSpawns(), mLevelData.getSpawnCount(), mNextSpawnPoint, mSpawnPosition);
+		}
+	}
 }
 
-void World::spawnEnemies()
+std::size_t World::spawnGroup(const LevelFormat::Spawn* spawns, std::size_t count, std::size_t first, sf::Vector2f origin)
 {
-	// Spawn all enemies entering the view area (including distance) this frame
-	while (!mEnemySpawnPoints.empty()
-		&& mEnemySpawnPoints.back().y > getBattlefieldBounds().top)
+	if (spawns[first].type == LevelFormat::SwarmType)
+	{
+		std::unique_ptr<SwarmNode> swarm(new SwarmNode(mTextures, mPlayerAircrafts));
+		swarm->addDrones(sf::Vector2f(origin.x + spawns[first].x, origin.y - spawns[first].distance), spawns[first].count);
+		mSceneLayers[UpperAir]->attachChild(std::move(swarm));
+		return first + 1;
+	}
+
+	std::size_t end = first + 1;
+	while (end < count && isSameFormation(spawns[first], spawns[end]))
+		++end;
+
+	std::unique_ptr<Aircraft> leader = createEnemy(spawns[first], origin);
+	if (end - first == 1)
 	{
-		SpawnPoint spawn = mEnemySpawnPoints.back();
+		mSceneLayers[UpperAir]->attachChild(std::move(leader));
+		return end;
+	}
+
+	// The formation takes over the leader's position and movement pattern
+	Aircraft::Type pattern = (spawns[first].pattern != LevelFormat::OwnPattern) ? static_cast<Aircraft::Type>(spawns[first].pattern) : leader->getType();
+	std::unique_ptr<FormationNode> formation(new FormationNode(*leader, pattern));
+
+	formation->addMember(std::move(leader));
+	for (std::size_t i = first + 1; i < end; ++i)
+		formation->addMember(createEnemy(spawns[i], origin));
+
+	mFormations.push_back(formation.get());
+	mSceneLayers[UpperAir]->attachChild(std::move(formation));
+
+	return end;
+}
 
-		std::unique_ptr<Aircraft> enemy(new Aircraft(spawn.type, mTextures, mFonts));
-		enemy->setPosition(spawn.x, spawn.y);
-		enemy->setRotation(180.f);
+std::unique_ptr<Aircraft> World::createEnemy(const LevelFormat::Spawn& spawn, sf::Vector2f origin)
+{
+	std::unique_ptr<Aircraft> enemy = mEnemyPool.acquire(static_cast<Aircraft::Type>(spawn.type));
+	enemy->setPosition(origin.x + spawn.x, origin.y - spawn.distance);
+	enemy->setRotation(180.f);
+	if (spawn.pattern != LevelFormat::OwnPattern)
+		enemy->setMovementPattern(static_cast<Aircraft::Type>(spawn.pattern));
 
-		mSceneLayers[UpperAir]->attachChild(std::move(enemy));
+	return enemy;
+}
 
-		// Enemy is spawned, remove from the list to spawn
-		mEnemySpawnPoints.pop_back();
+void World::updateFormations()
+{
+	// A formation breaks up when its leader is shot down, the others fly on by themselves
+	bool released = false;
+	for (auto itr = mFormations.begin(); itr != mFormations.end(); )
+	{
+		FormationNode& formation = **itr;
+		if (!formation.isEmpty() && formation.isBroken())
+		{
+			formation.release(*mSceneLayers[UpperAir]);
+			released = true;
+		}
+
+		// Empty formations are removed with the wrecks
+		if (formation.isEmpty())
+			itr = mFormations.erase(itr);
+		else
+			++itr;
 	}
+
+	// Released members go back to where creation order puts them, so that the update order stays reproducible
+	if (released)
+		mSceneLayers[UpperAir]->sortChildren(&hasSmallerEntityId);
+}
+
+void World::startChunk(std::size_t index)
+{
+	// Spawns are kept relative to the chunk, whose origin moves with the floating origin
+	mGenerator.generateChunk(index, mChunkSpawns);
+	mChunkIndex = index;
+	mNextSpawnPoint = 0;
+	mPrefetchPoint = 0;
+}
+
+void World::scrollBackground()
+{
+	// Move the background by whole tiles, which is invisible, so that its top stays within one tile above the view
+	float tiles = std::ceil((mBackground->getPosition().y - getViewBounds().top) / mBackgroundTileHeight);
+	if (tiles != 0.f)
+		mBackground->move(0.f, -tiles * mBackgroundTileHeight);
 }
 
 void World::destroyEntitiesOutsideView()
@@ -813,6 +1064,17 @@ void World::destroyEntitiesOutsideView()
 	});
 
 	mCommandQueue.push(command);
+
+	Command swarmCommand;
+	swarmCommand.category = Category::Swarm;
+	swarmCommand.action = derivedAction<SwarmNode>([this] (SwarmNode& swarm, sf::Time)
+	{
+		swarm.removeOutside(getBattlefieldBounds());
+	});
+
+	mCommandQueue.push(swarmCommand);
+
+	mBullets->removeOutside(getBattlefieldBounds());
 }
 
 void World::guideMissiles()
@@ -861,6 +1123,26 @@ void World::guideMissiles()
 	mActiveEnemies.clear();
 }
 
+void World::updateDetailLevels()
+{
+	// Pick each enemy's simulation detail by its distance from the visible area
+	Command command;
+	command.category = Category::EnemyAircraft;
+	command.action = derivedAction<Aircraft>([this] (Aircraft& enemy, sf::Time)
+	{
+		sf::FloatRect viewBounds = getViewBounds();
+
+		if (enemy.getBoundingRect().intersects(viewBounds))
+			enemy.setDetailLevel(Aircraft::FullDetail);
+		else if (distanceToRect(enemy.getWorldPosition(), viewBounds) < SpawnMargin / 2.f)
+			enemy.setDetailLevel(Aircraft::ReducedDetail);
+		else
+			enemy.setDetailLevel(Aircraft::MinimalDetail);
+	});
+
+	mCommandQueue.push(command);
+}
+
 sf::FloatRect World::getViewBounds() const
 {
 	return sf::FloatRect(mWorldView.getCenter() - mWorldView.getSize() / 2.f, mWorldView.getSize());
@@ -870,8 +1152,8 @@ sf::FloatRect World::getBattlefieldBounds() const
 {
 	// Return view bounds + some area at top, where enemies spawn
 	sf::FloatRect bounds = getViewBounds();
-	bounds.top -= 100.f;
-	bounds.height += 100.f;
+	bounds.top -= SpawnMargin;
+	bounds.height += SpawnMargin;
 
 	return bounds;
 }
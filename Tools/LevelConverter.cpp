@@ -0,0 +1,150 @@
+// Converts a text level description into the binary format loaded by the game:
+//
+//   LevelConverter Media/Levels/Level1.txt Media/Levels/Level1.lvl
+//
+// Every line of the input names an enemy type, its horizontal offset and its distance
+// from the player's start, optionally followed by the type whose movement pattern it
+// flies. A drone swarm is written as 'Swarm <x> <distance> <drone count>'. Everything
+// after a '#' is a comment.
+
+#include "LevelFormat.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	// In the order of Aircraft::Type
+	const char* TypeNames[] = { "Eagle", "Raptor", "Avenger", "C83" };
+	const std::size_t TypeCount = sizeof(TypeNames) / sizeof(TypeNames[0]);
+
+	// The first type is the player's aircraft
+	const std::size_t FirstEnemyType = 1;
+
+	int findType(const std::string& name)
+	{
+		for (std::size_t i = FirstEnemyType; i < TypeCount; ++i)
+		{
+			if (name == TypeNames[i])
+				return static_cast<int>(i);
+		}
+
+		return -1;
+	}
+
+	bool fail(const std::string& message)
+	{
+		std::cerr << "LevelConverter: " << message << std::endl;
+		return false;
+	}
+
+	bool readSpawns(const char* filename, std::vector<LevelFormat::Spawn>& spawns)
+	{
+		std::ifstream input(filename);
+		if (!input)
+			return fail(std::string("failed to open ") + filename);
+
+		std::string line;
+		for (std::size_t lineNumber = 1; std::getline(input, line); ++lineNumber)
+		{
+			std::istringstream stream(line.substr(0, line.find('#')));
+			std::string location = std::string(filename) + ":" + std::to_string(lineNumber) + ": ";
+
+			std::string typeName;
+			if (!(stream >> typeName))
+				continue;
+
+			LevelFormat::Spawn spawn;
+			std::memset(&spawn, 0, sizeof(spawn));
+
+			if (typeName == "Swarm")
+			{
+				unsigned int count = 0;
+				if (!(stream >> spawn.x >> spawn.distance >> count) || count == 0 || count > 0xffff)
+					return fail(location + "expected a position and a drone count after 'Swarm'");
+
+				spawn.type = LevelFormat::SwarmType;
+				spawn.pattern = LevelFormat::OwnPattern;
+				spawn.count = static_cast<std::uint16_t>(count);
+				spawns.push_back(spawn);
+				continue;
+			}
+
+			int type = findType(typeName);
+			if (type < 0)
+				return fail(location + "unknown enemy type '" + typeName + "'");
+
+			if (!(stream >> spawn.x >> spawn.distance))
+				return fail(location + "expected a position after the type");
+
+			spawn.type = static_cast<std::uint8_t>(type);
+			spawn.pattern = LevelFormat::OwnPattern;
+
+			std::string patternName;
+			if (stream >> patternName)
+			{
+				int pattern = findType(patternName);
+				if (pattern < 0)
+					return fail(location + "unknown movement pattern '" + patternName + "'");
+
+				spawn.pattern = static_cast<std::uint8_t>(pattern);
+			}
+
+			spawns.push_back(spawn);
+		}
+
+		return true;
+	}
+
+	bool writeLevel(const char* filename, const std::vector<LevelFormat::Spawn>& spawns)
+	{
+		std::ofstream output(filename, std::ios::binary | std::ios::trunc);
+		if (!output)
+			return fail(std::string("failed to create ") + filename);
+
+		LevelFormat::Header header;
+		std::memcpy(header.magic, LevelFormat::Magic, sizeof(header.magic));
+		header.version = LevelFormat::Version;
+		header.spawnCount = static_cast<std::uint32_t>(spawns.size());
+
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (!spawns.empty())
+			output.write(reinterpret_cast<const char*>(spawns.data()), spawns.size() * sizeof(LevelFormat::Spawn));
+
+		if (!output)
+			return fail(std::string("failed to write ") + filename);
+
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: LevelConverter <level.txt> <level.lvl>" << std::endl;
+		return 1;
+	}
+
+	std::vector<LevelFormat::Spawn> spawns;
+	if (!readSpawns(argv[1], spawns))
+		return 1;
+
+	// The game spawns enemies in file order; equal distances keep their order from the text file
+	std::stable_sort(spawns.begin(), spawns.end(), [] (const LevelFormat::Spawn& lhs, const LevelFormat::Spawn& rhs)
+	{
+		return lhs.distance < rhs.distance;
+	});
+
+	if (!writeLevel(argv[2], spawns))
+		return 1;
+
+	std::cout << argv[2] << ": " << spawns.size() << " enemies" << std::endl;
+	return 0;
+}
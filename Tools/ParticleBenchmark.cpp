@@ -0,0 +1,202 @@
+// Measures the particle update with 100k live particles, comparing the ring buffer used by
+// ParticleNode with the deque of particle structs it replaced. Then times the update together with
+// the quad generation at 10k, 50k and 200k particles, serially and split over the worker threads:
+//
+//   g++ -O2 -std=c++11 -IHeaders Tools/ParticleBenchmark.cpp Source/ParticleBuffer.cpp Source/WorkerPool.cpp -lsfml-system -o ParticleBenchmark
+//   ParticleBenchmark [worker threads]
+//
+// Only the SFML system library is needed. Every particle lives longer than the measured ticks, so all
+// variants always update the full set. Without an argument the pool gets as many workers as the game
+// would, which is none on a single core: pass a thread count there to see the overhead of the split.
+
+#include "ParticleBuffer.hpp"
+#include "WorkerPool.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+namespace
+{
+	const std::size_t ParticleCount = 100000;
+	const std::size_t TickCount = 600;
+	const float TickLength = 1.f / 60.f;
+	const float Lifetime = 3600.f;
+	const float Drag = 1.f;
+
+	// ParticleNode's chunk size, and the sizes it is measured with
+	const std::size_t MinChunkSize = 4096;
+	const std::size_t ScalingCounts[] = { 10000, 50000, 200000 };
+	const std::size_t ScalingTickCount = 120;
+
+	// Same layout as sf::Vertex, which would need the graphics library to be linked
+	struct Vertex
+	{
+		sf::Vector2f	position;
+		unsigned char	color[4];
+		sf::Vector2f	texCoords;
+	};
+
+	// What ParticleNode used to store per particle, with velocity added for a fair comparison
+	struct LegacyParticle
+	{
+		sf::Vector2f	position;
+		sf::Vector2f	velocity;
+		unsigned int	color;
+		float			lifetime;
+	};
+
+	typedef std::chrono::high_resolution_clock Clock;
+
+	double toMicroseconds(Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+
+	sf::Vector2f velocityOf(std::size_t i)
+	{
+		return sf::Vector2f(static_cast<float>(i % 17) - 8.f, static_cast<float>(i % 13) - 6.f);
+	}
+
+	double runBuffer(float& checksum)
+	{
+		ParticleBuffer particles(ParticleCount);
+		for (std::size_t i = 0; i < ParticleCount; ++i)
+			particles.add(sf::Vector2f(static_cast<float>(i % 800), static_cast<float>(i % 600)), velocityOf(i), Lifetime);
+
+		Clock::time_point start = Clock::now();
+		for (std::size_t tick = 0; tick < TickCount; ++tick)
+			particles.update(TickLength, Drag);
+		Clock::duration elapsed = Clock::now() - start;
+
+		checksum = particles.getPosition(ParticleCount / 2).x + particles.getLifetime(0);
+		return toMicroseconds(elapsed) / TickCount;
+	}
+
+	double runDeque(float& checksum)
+	{
+		std::deque<LegacyParticle> particles;
+		for (std::size_t i = 0; i < ParticleCount; ++i)
+		{
+			LegacyParticle particle;
+			particle.position = sf::Vector2f(static_cast<float>(i % 800), static_cast<float>(i % 600));
+			particle.velocity = velocityOf(i);
+			particle.color = 0xffffffff;
+			particle.lifetime = Lifetime;
+			particles.push_back(particle);
+		}
+
+		Clock::time_point start = Clock::now();
+		for (std::size_t tick = 0; tick < TickCount; ++tick)
+		{
+			float damping = std::exp(-Drag * TickLength);
+
+			while (!particles.empty() && particles.front().lifetime <= 0.f)
+				particles.pop_front();
+
+			for (std::deque<LegacyParticle>::iterator itr = particles.begin(); itr != particles.end(); ++itr)
+			{
+				itr->velocity *= damping;
+				itr->position += itr->velocity * TickLength;
+				itr->lifetime -= TickLength;
+			}
+		}
+		Clock::duration elapsed = Clock::now() - start;
+
+		checksum = particles[ParticleCount / 2].position.x + particles.front().lifetime;
+		return toMicroseconds(elapsed) / TickCount;
+	}
+
+	// The work ParticleNode does per particle and frame when every quad has to be rewritten
+	void writeQuads(const ParticleBuffer& particles, std::size_t begin, std::size_t end, Vertex* vertices)
+	{
+		const float half = 4.f;
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			sf::Vector2f pos = particles.getPosition(i);
+			unsigned char alpha = static_cast<unsigned char>(255.f * std::max(particles.getLifetime(i) / Lifetime, 0.f));
+
+			Vertex* quad = vertices + i * 4;
+			for (int corner = 0; corner < 4; ++corner)
+			{
+				float x = (corner == 1 || corner == 2) ? half : -half;
+				float y = (corner >= 2) ? half : -half;
+
+				quad[corner].position = sf::Vector2f(pos.x + x, pos.y + y);
+				quad[corner].texCoords = sf::Vector2f(x + half, y + half);
+				quad[corner].color[0] = quad[corner].color[1] = quad[corner].color[2] = 255;
+				quad[corner].color[3] = alpha;
+			}
+		}
+	}
+
+	double runFrames(WorkerPool& workers, std::size_t count, float& checksum)
+	{
+		ParticleBuffer particles(count);
+		for (std::size_t i = 0; i < count; ++i)
+			particles.add(sf::Vector2f(static_cast<float>(i % 800), static_cast<float>(i % 600)), velocityOf(i), Lifetime);
+
+		std::vector<Vertex> vertices(count * 4);
+
+		Clock::time_point start = Clock::now();
+		for (std::size_t tick = 0; tick < ScalingTickCount; ++tick)
+		{
+			workers.run(particles.getSize(), MinChunkSize, [&particles] (std::size_t begin, std::size_t end)
+			{
+				particles.integrate(begin, end, TickLength, Drag);
+			});
+			particles.removeExpired();
+
+			workers.run(particles.getSize(), MinChunkSize, [&particles, &vertices] (std::size_t begin, std::size_t end)
+			{
+				writeQuads(particles, begin, end, &vertices[0]);
+			});
+		}
+		Clock::duration elapsed = Clock::now() - start;
+
+		checksum = vertices[count * 2].position.x;
+		return toMicroseconds(elapsed) / ScalingTickCount;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	float bufferChecksum = 0.f;
+	float dequeChecksum = 0.f;
+
+	double buffer = runBuffer(bufferChecksum);
+	double deque = runDeque(dequeChecksum);
+
+	std::cout << ParticleCount << " particles, " << TickCount << " ticks" << std::endl;
+	std::cout << "  ring buffer: " << buffer << " us per tick" << std::endl;
+	std::cout << "  deque:       " << deque << " us per tick" << std::endl;
+
+	// Printing the results keeps the compiler from dropping the work
+	std::cout << "  checksums:   " << bufferChecksum << " / " << dequeChecksum << std::endl;
+
+	// The serial pool has no threads, so every loop runs on the calling thread
+	WorkerPool serial(0);
+	WorkerPool parallel(argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : WorkerPool::getDefaultThreadCount());
+
+	std::cout << std::endl << "update and quads, " << parallel.getThreadCount() << " worker threads" << std::endl;
+	for (std::size_t i = 0; i < sizeof(ScalingCounts) / sizeof(ScalingCounts[0]); ++i)
+	{
+		float serialChecksum = 0.f;
+		float parallelChecksum = 0.f;
+
+		double serialTime = runFrames(serial, ScalingCounts[i], serialChecksum);
+		double parallelTime = runFrames(parallel, ScalingCounts[i], parallelChecksum);
+
+		std::cout << "  " << ScalingCounts[i] << " particles: " << serialTime << " us serial, " << parallelTime
+			<< " us parallel, speedup " << serialTime / parallelTime << " (checksums " << serialChecksum
+			<< " / " << parallelChecksum << ")" << std::endl;
+	}
+
+	return 0;
+}
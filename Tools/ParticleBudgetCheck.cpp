@@ -0,0 +1,68 @@
+// Checks that the particle budget throttles emission before the ring buffers fill up:
+//
+//   g++ -std=c++11 -IHeaders Tools/ParticleBudgetCheck.cpp $(ls Source/*.cpp | grep -v Main.cpp) \
+//       -lsfml-audio -lsfml-graphics -lsfml-window -lsfml-network -lsfml-system -o ParticleBudgetCheck
+//   ParticleBudgetCheck
+//
+// For every particle type, a crowd of emitters in the middle of the view emits as fast as the budget
+// lets it, far more than a ring buffer of that type could hold unthrottled. The live particles must
+// level off at the budget, below the capacity, and the emitters must have been slowed down to get there.
+
+#include "ParticleBudget.hpp"
+#include "ParticleBuffer.hpp"
+#include "DataTables.hpp"
+
+#include <iostream>
+
+
+namespace
+{
+	const std::size_t EmitterCount = 400;
+	const std::size_t TickCount = 60 * 20;
+	const float TickLength = 1.f / 60.f;
+
+	bool checkType(const ParticleBudget& budget, Particle::Type type, const ParticleData& data)
+	{
+		sf::Vector2f position(512.f, 384.f);
+		ParticleBuffer particles(data.capacity);
+		float owed = 0.f;
+		std::size_t peak = 0;
+
+		for (std::size_t tick = 0; tick < TickCount; ++tick)
+		{
+			particles.update(TickLength, data.drag);
+
+			// All emitters share the position, so they are all granted the same rate
+			owed += budget.getEmissionRate(type, position, particles.getSize()) * EmitterCount * TickLength;
+			for (; owed >= 1.f; owed -= 1.f)
+				particles.add(position, sf::Vector2f(), data.lifetime.asSeconds());
+
+			peak = std::max(peak, particles.getSize());
+		}
+
+		float unthrottled = data.emissionRate * EmitterCount * data.lifetime.asSeconds();
+		float rate = budget.getEmissionRate(type, position, particles.getSize());
+		bool passed = unthrottled > data.capacity && peak <= data.budget && data.budget <= data.capacity
+			&& rate < data.emissionRate;
+
+		std::cout << "type " << type << ": " << unthrottled << " particles unthrottled, peak " << peak << " of budget "
+			<< data.budget << " and capacity " << data.capacity << ", rate " << rate << " of " << data.emissionRate
+			<< ": " << (passed ? "passed" : "FAILED") << std::endl;
+
+		return passed;
+	}
+}
+
+int main()
+{
+	std::vector<ParticleData> table = initializeParticleData();
+
+	ParticleBudget budget;
+	budget.setViewBounds(sf::FloatRect(0.f, 0.f, 1024.f, 768.f));
+
+	bool passed = true;
+	for (std::size_t type = 0; type < Particle::ParticleCount; ++type)
+		passed = checkType(budget, static_cast<Particle::Type>(type), table[type]) && passed;
+
+	return passed ? 0 : 1;
+}
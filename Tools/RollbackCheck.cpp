@@ -0,0 +1,89 @@
+// Checks that rollback netplay keeps the actual inputs of a remote player who runs ahead:
+//
+//   g++ -std=c++11 -IHeaders Tools/RollbackCheck.cpp $(ls Source/*.cpp | grep -v Main.cpp) \
+//       -lsfml-audio -lsfml-graphics -lsfml-window -lsfml-network -lsfml-system -o RollbackCheck
+//   RollbackCheck
+//
+// Run it from the repository root, the world loads its media from there. A scripted remote peer sends
+// the inputs of several frames before the session has simulated any of them: moving left for the first
+// half, then nothing. The session must simulate those inputs rather than its own prediction, which
+// continues the last confirmed one, so the remote aircraft has to end up left of where it started.
+
+#include "World.hpp"
+#include "RollbackSession.hpp"
+#include "NetworkLink.hpp"
+#include "SoundPlayer.hpp"
+#include "ResourceHolder.hpp"
+#include "Utility.hpp"
+
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include <iostream>
+
+
+namespace
+{
+	const unsigned short SessionPort = 50100;
+	const unsigned short PeerPort = 50101;
+
+	const sf::Int32 FrameCount = 8;
+	const sf::Time TimePerFrame = sf::seconds(1.f / 60.f);
+}
+
+int main()
+{
+	sf::RenderTexture target;
+	target.create(1024, 768);
+
+	FontHolder fonts;
+	fonts.load(Fonts::Main, "Media/sansation.ttf");
+	fonts.load(Fonts::Arcade, "Media/emulogic.ttf");
+	SoundPlayer sounds;
+
+	getRandomEngine().seed(2000);
+	World world(target, fonts, sounds);
+	Aircraft* remoteAircraft = world.addAircraft(2);
+	float startX = remoteAircraft->getPosition().x;
+
+	Player localPlayer(1);
+	Player remotePlayer(2);
+	NetworkLink link;
+	if (!link.bind(SessionPort))
+	{
+		std::cout << "Failed to bind port " << SessionPort << std::endl;
+		return 1;
+	}
+	link.setRemote(sf::IpAddress::LocalHost, PeerPort);
+
+	RollbackSession session(world, localPlayer, remotePlayer, link, sounds);
+
+	// The peer is a whole rollback window ahead: all its inputs arrive before the first frame is simulated
+	sf::UdpSocket peer;
+	if (peer.bind(PeerPort) != sf::Socket::Done)
+	{
+		std::cout << "Failed to bind port " << PeerPort << std::endl;
+		return 1;
+	}
+
+	sf::Packet packet;
+	packet << sf::Int32(-1) << sf::Int32(-1) << sf::Uint32(0) << sf::Int32(0) << static_cast<sf::Uint8>(FrameCount);
+	for (sf::Int32 frame = 0; frame < FrameCount; ++frame)
+		packet << static_cast<Player::ActionSet>(frame < FrameCount / 2 ? 1 << Player::MoveLeft : 0);
+
+	peer.send(packet, sf::IpAddress::LocalHost, SessionPort);
+	sf::sleep(sf::milliseconds(100));
+
+	for (sf::Int32 frame = 0; frame < FrameCount; ++frame)
+		session.update(TimePerFrame);
+
+	float endX = remoteAircraft->getPosition().x;
+	bool passed = session.getConfirmedFrame() == FrameCount - 1 && session.isConfirmed() && endX < startX;
+
+	std::cout << "confirmed frame " << session.getConfirmedFrame() << " of " << session.getFrame() - 1
+		<< ", remote aircraft x " << startX << " -> " << endX << ": " << (passed ? "passed" : "FAILED") << std::endl;
+
+	return passed ? 0 : 1;
+}